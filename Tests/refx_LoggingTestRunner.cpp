@@ -0,0 +1,23 @@
+// Runs the unit tests and benchmarks of the refx_logging module, see CMakeLists.txt
+
+#include <juce_core/juce_core.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+//-------------------------------------------------------------------------------------------------
+
+int main ()
+{
+	juce::ScopedJuceInitialiser_GUI	init;
+	juce::UnitTestRunner			runner;
+
+	runner.setAssertOnFailure ( false );
+	runner.runTestsInCategory ( "reFX" );
+
+	auto	failures = 0;
+
+	for ( int i = 0; i < runner.getNumResults (); ++i )
+		failures += runner.getResult ( i )->failures;
+
+	return failures > 0 ? 1 : 0;
+}
+//-------------------------------------------------------------------------------------------------
@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <array>
+
+#include "refx_BinaryLogFormat.h"
+#include "refx_MappedLogFile.h"
+
+//-------------------------------------------------------------------------------------------------
+
+namespace reFX
+{
+
+static const char	binaryLogFileMagic[ 8 ] = { 'R', 'F', 'X', 'B', 'L', 'O', 'G', 0 };
+
+template <typename T>
+static void writeLittleEndian ( juce::uint8* dst, T value )
+{
+	for ( size_t i = 0; i < sizeof ( T ); ++i )
+		dst[ i ] = juce::uint8 ( juce::uint64 ( value ) >> ( 8 * i ) );
+}
+
+//-------------------------------------------------------------------------------------------------
+
+juce::uint32 BinaryLogFormat::crc32 ( const void* data, size_t size, juce::uint32 crc )
+{
+	static const auto	table = []
+	{
+		std::array<juce::uint32, 256>	t {};
+
+		for ( juce::uint32 i = 0; i < 256; ++i )
+		{
+			auto	c = i;
+
+			for ( int k = 0; k < 8; ++k )
+				c = ( c & 1 ) != 0 ? 0xEDB88320u ^ ( c >> 1 ) : c >> 1;
+
+			t[ i ] = c;
+		}
+
+		return t;
+	} ();
+
+	auto	p = static_cast<const juce::uint8*> ( data );
+
+	crc = ~crc;
+
+	for ( size_t i = 0; i < size; ++i )
+		crc = table[ ( crc ^ p[ i ] ) & 0xff ] ^ ( crc >> 8 );
+
+	return ~crc;
+}
+//-------------------------------------------------------------------------------------------------
+
+void BinaryLogFormat::writeFileHeader ( juce::OutputStream& out )
+{
+	out.write ( binaryLogFileMagic, sizeof ( binaryLogFileMagic ) );
+	out.writeInt ( int ( version ) );
+	out.writeInt ( 0 );
+}
+//-------------------------------------------------------------------------------------------------
+
+void BinaryLogFormat::writeRecord ( juce::OutputStream& out, const LogMessage& msg )
+{
+	const auto	text = msg.description.toRawUTF8 ();
+	const auto	textSize = juce::uint32 ( msg.description.getNumBytesAsUTF8 () );
+	const auto	name = msg.threadName.toRawUTF8 ();
+	const auto	nameSize = juce::uint32 ( juce::jmin ( msg.threadName.getNumBytesAsUTF8 (), size_t ( 255 ) ) );
+
+	juce::uint8	header[ recordHeaderSize ] = { 0 };
+
+	writeLittleEndian ( header + 0, recordMagic );
+	writeLittleEndian ( header + 4, nameSize + textSize );
+	writeLittleEndian ( header + 8, juce::uint64 ( msg.timeNs ) );
+	writeLittleEndian ( header + 16, msg.threadId );
+	header[ 24 ] = juce::uint8 ( msg.level );
+	header[ 25 ] = juce::uint8 ( nameSize );
+
+	auto	crc = crc32 ( header, recordHeaderSize - 4 );
+	crc = crc32 ( name, nameSize, crc );
+	crc = crc32 ( text, textSize, crc );
+	writeLittleEndian ( header + 28, crc );
+
+	out.write ( header, sizeof ( header ) );
+	out.write ( name, nameSize );
+	out.write ( text, textSize );
+}
+//-------------------------------------------------------------------------------------------------
+
+bool BinaryLogFormat::isBinaryLog ( juce::InputStream& in )
+{
+	char	magic[ sizeof ( binaryLogFileMagic ) ] = { 0 };
+
+	return in.read ( magic, sizeof ( magic ) ) == int ( sizeof ( magic ) ) && std::memcmp ( magic, binaryLogFileMagic, sizeof ( magic ) ) == 0;
+}
+//-------------------------------------------------------------------------------------------------
+
+bool BinaryLogFormat::isBinaryLog ( const juce::File& f )
+{
+	auto	in = openFile ( f );
+
+	return in != nullptr && isBinaryLog ( *in );
+}
+//-------------------------------------------------------------------------------------------------
+
+bool BinaryLogFormat::readVersion ( juce::InputStream& in, juce::uint32& fileVersion )
+{
+	fileVersion = juce::uint32 ( in.readInt () );
+
+	return fileVersion >= 1 && fileVersion <= version;
+}
+//-------------------------------------------------------------------------------------------------
+
+bool BinaryLogFormat::RecordReader::read ( LogMessage& msg )
+{
+	juce::uint8	header[ recordHeaderSize ];
+
+	for (;;)
+	{
+		if ( readBytes ( header, recordHeaderSize ) != recordHeaderSize )
+			return false;
+
+		const auto	payloadSize = juce::ByteOrder::littleEndianInt ( header + 4 );
+
+		// Compressed streams do not know their length
+		const auto	remaining = in.getNumBytesRemaining ();
+
+		auto	valid = juce::ByteOrder::littleEndianInt ( header ) == recordMagic
+					 && header[ 24 ] <= juce::uint8 ( LogLevel::error )
+					 && payloadSize <= maxPayloadSize
+					 && header[ 25 ] <= payloadSize
+					 && ( remaining < 0 || juce::int64 ( payloadSize ) <= remaining + juce::int64 ( lookahead.getSize () - lookaheadPos ) );
+
+		size_t	payloadRead = 0;
+
+		if ( valid )
+		{
+			payload.setSize ( payloadSize, false );
+			payloadRead = readBytes ( payload.getData (), payloadSize );
+			valid = payloadRead == payloadSize;
+		}
+
+		if ( valid )
+		{
+			auto	crc = crc32 ( header, recordHeaderSize - 4 );
+			crc = crc32 ( payload.getData (), payloadSize, crc );
+
+			valid = crc == juce::ByteOrder::littleEndianInt ( header + 28 );
+		}
+
+		if ( valid )
+		{
+			const auto	data = static_cast<const char*> ( payload.getData () );
+			const auto	nameSize = int ( header[ 25 ] );
+
+			msg.threadName = juce::String::fromUTF8 ( data, nameSize );
+			msg.description = juce::String::fromUTF8 ( data + nameSize, int ( payloadSize ) - nameSize );
+			msg.timeNs = juce::int64 ( juce::ByteOrder::littleEndianInt64 ( header + 8 ) );
+			msg.threadId = juce::ByteOrder::littleEndianInt64 ( header + 16 );
+			msg.level = LogLevel ( header[ 24 ] );
+			return true;
+		}
+
+		// Damaged or torn record, e.g. after a crash. The next one may start anywhere after its
+		// first byte, including in the bytes read for it.
+		juce::MemoryBlock	rest ( header + 1, recordHeaderSize - 1 );
+
+		if ( payloadRead > 0 )
+			rest.append ( payload.getData (), payloadRead );
+
+		if ( lookaheadPos < lookahead.getSize () )
+			rest.append ( static_cast<const char*> ( lookahead.getData () ) + lookaheadPos, lookahead.getSize () - lookaheadPos );
+
+		lookahead = std::move ( rest );
+		lookaheadPos = 0;
+
+		if ( ! skipToNextRecord () )
+			return false;
+	}
+}
+//-------------------------------------------------------------------------------------------------
+
+size_t BinaryLogFormat::RecordReader::readBytes ( void* dest, size_t numBytes )
+{
+	const auto	fromLookahead = std::min ( numBytes, lookahead.getSize () - lookaheadPos );
+
+	if ( fromLookahead > 0 )
+	{
+		std::memcpy ( dest, static_cast<const char*> ( lookahead.getData () ) + lookaheadPos, fromLookahead );
+		lookaheadPos += fromLookahead;
+	}
+
+	if ( fromLookahead == numBytes )
+		return numBytes;
+
+	return fromLookahead + size_t ( juce::jmax ( 0, in.read ( static_cast<char*> ( dest ) + fromLookahead, int ( numBytes - fromLookahead ) ) ) );
+}
+//-------------------------------------------------------------------------------------------------
+
+bool BinaryLogFormat::RecordReader::skipToNextRecord ()
+{
+	static const juce::uint8	magic[ 4 ] = { 'R', 'F', 'X', 'R' };
+
+	for (;;)
+	{
+		const auto	data = static_cast<const juce::uint8*> ( lookahead.getData () );
+		const auto	end = data + lookahead.getSize ();
+		const auto	found = std::search ( data + lookaheadPos, end, magic, magic + 4 );
+
+		if ( found != end )
+		{
+			lookaheadPos = size_t ( found - data );
+			return true;
+		}
+
+		// A magic may be cut off at the end, its start is kept for the next search
+		const auto	keep = std::min ( size_t ( end - ( data + lookaheadPos ) ), sizeof ( magic ) - 1 );
+
+		juce::MemoryBlock	next ( 65536 + keep, false );
+
+		if ( keep > 0 )
+			std::memcpy ( next.getData (), end - keep, keep );
+
+		const auto	n = in.read ( static_cast<char*> ( next.getData () ) + keep, 65536 );
+
+		if ( n <= 0 )
+			return false;
+
+		next.setSize ( keep + size_t ( n ), false );
+
+		lookahead = std::move ( next );
+		lookaheadPos = 0;
+	}
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String BinaryLogFormat::loadFileAsText ( const juce::File& f )
+{
+	auto	in = openFile ( f );
+
+	return in != nullptr ? readAsText ( *in ) : juce::String ();
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String BinaryLogFormat::readAsText ( juce::InputStream& in )
+{
+	juce::MemoryOutputStream	text;
+
+	copyAsText ( in, text );
+
+	return text.toUTF8 ();
+}
+//-------------------------------------------------------------------------------------------------
+
+std::unique_ptr<juce::InputStream> BinaryLogFormat::openFile ( const juce::File& f )
+{
+	auto	file = std::make_unique<juce::FileInputStream> ( f );
+
+	if ( ! file->openedOk () )
+		return nullptr;
+
+	std::unique_ptr<juce::InputStream>	in;
+
+	if ( f.hasFileExtension ( compressedFileExtension ) )
+		in = std::make_unique<juce::GZIPDecompressorInputStream> ( file.release (), true, juce::GZIPDecompressorInputStream::gzipFormat );
+	else
+		in = std::move ( file );
+
+	// Mapped log files are only read up to their committed end, see MappedLogFile
+	if ( const auto end = MappedLogFile::readCommittedEnd ( *in ) )
+		return std::make_unique<juce::SubregionStream> ( in.release (), MappedLogFile::headerSize, *end - MappedLogFile::headerSize, true );
+
+	in->setPosition ( 0 );
+
+	return in;
+}
+//-------------------------------------------------------------------------------------------------
+
+bool BinaryLogFormat::copyAsText ( juce::InputStream& in, juce::OutputStream& out, const std::function<bool ()>& keepGoing )
+{
+	const auto	binary = isBinaryLog ( in );
+
+	if ( ! binary )
+	{
+		in.setPosition ( 0 );
+
+		juce::HeapBlock<char>	buffer ( 65536 );
+
+		for ( int n; ( n = in.read ( buffer, 65536 ) ) > 0; )
+			if ( ! out.write ( buffer, size_t ( n ) ) || ( keepGoing && ! keepGoing () ) )
+				return false;
+
+		return true;
+	}
+
+	juce::uint32	fileVersion;
+
+	if ( ! readVersion ( in, fileVersion ) )
+		return out.writeText ( "Unsupported binary log file version " + juce::String ( fileVersion ) + "\r\n", false, false, nullptr );
+
+	in.setPosition ( fileHeaderSize );
+
+	RecordReader	reader ( in );
+	auto			count = 0;
+
+	for ( LogMessage msg; reader.read ( msg ); )
+	{
+		msg.writeTo ( out );
+
+		if ( ! out.write ( "\r\n", 2 ) )
+			return false;
+
+		if ( ++count % 1024 == 0 && keepGoing && ! keepGoing () )
+			return false;
+	}
+
+	return true;
+}
+//-------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+namespace reFX
+{
+//-------------------------------------------------------------------------------------------------
+// Compact on-disk format used when LogWriterOptions::format is LogFileFormat::binary.
+//
+// File:	16 byte header ("RFXBLOG" + NUL, version, reserved), followed by records
+// Record:	32 byte little-endian header followed by the UTF-8 payload
+//
+//	uint32	magic			'RFXR'
+//	uint32	payloadSize		bytes of UTF-8 after the header, thread name and text
+//	int64	timeNs			nanoseconds since the Unix epoch
+//	uint64	threadId
+//	uint8	level			LogLevel
+//	uint8	nameSize		bytes of the payload that hold the thread name (always 0 in version 1)
+//	uint8	reserved[ 2 ]
+//	uint32	checksum		CRC-32 of the header bytes before it and the payload
+//
+// Text is only produced when a file is read, the decoder gives the same layout as text files.
+
+class BinaryLogFormat
+{
+public:
+	static constexpr const char*	fileExtension = ".rlog";
+	static constexpr int			fileHeaderSize = 16;
+	static constexpr int			recordHeaderSize = 32;
+	static constexpr juce::uint32	version = 2;
+
+	static void writeFileHeader ( juce::OutputStream& );
+	static void writeRecord ( juce::OutputStream&, const LogMessage& );
+
+	static bool isBinaryLog ( juce::InputStream& );
+	static bool isBinaryLog ( const juce::File& );
+
+	// Reads the version that follows the magic checked by isBinaryLog. Returns false for versions
+	// this code does not know, their records cannot be read.
+	static bool readVersion ( juce::InputStream&, juce::uint32& fileVersion );
+
+	// Reads the records of a stream one after the other. Damaged data is skipped by searching
+	// forward for the next record, the stream is never moved back. Seeking back in a compressed
+	// stream would decompress it from the beginning again.
+	class RecordReader
+	{
+	public:
+		explicit RecordReader ( juce::InputStream& s )
+			: in ( s ) {}
+
+		// Reads the next valid record. Returns false at the end of the stream.
+		bool read ( LogMessage& );
+
+		// Position in the stream of the next record read
+		juce::int64 getPosition ()		{ return in.getPosition () - juce::int64 ( lookahead.getSize () - lookaheadPos ); }
+
+	private:
+		size_t readBytes ( void* dest, size_t numBytes );		// Fewer only at the end of the stream
+		bool skipToNextRecord ();
+
+		juce::InputStream&	in;
+		juce::MemoryBlock	lookahead;			// Read from the stream already, but not parsed yet
+		size_t				lookaheadPos = 0;
+		juce::MemoryBlock	payload;
+	};
+
+	// Text of a log file in the format LogMessage::toString produces. Works for text and binary
+	// files, gzipped ones (see compressedFileExtension) are decompressed while reading.
+	static juce::String loadFileAsText ( const juce::File& );
+	static juce::String readAsText ( juce::InputStream& );
+
+	// Streaming variants for large files. openFile decompresses gzipped files and skips the header
+	// of mapped ones while reading, copyAsText stops and returns false if keepGoing does or
+	// writing fails.
+	static std::unique_ptr<juce::InputStream> openFile ( const juce::File& );
+	static bool copyAsText ( juce::InputStream&, juce::OutputStream&, const std::function<bool ()>& keepGoing = {} );
+
+	static constexpr const char*	compressedFileExtension = ".gz";
+
+	static juce::uint32 crc32 ( const void* data, size_t size, juce::uint32 crc = 0 );
+
+private:
+	static constexpr juce::uint32	recordMagic = 0x52584652;	// "RFXR"
+	static constexpr juce::uint32	maxPayloadSize = 16 * 1024 * 1024;
+};
+//-------------------------------------------------------------------------------------------------
+}
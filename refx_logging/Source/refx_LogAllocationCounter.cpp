@@ -0,0 +1,101 @@
+// Counts the allocations of each thread for the logging benchmarks, see REFX_LOG_BENCHMARKS.
+// This replaces the global operator new, so it is not part of the module. Add it to a benchmark
+// app only.
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+ #include <malloc.h>
+#endif
+
+namespace reFX
+{
+extern long long ( *allocationsOnThisThread ) ();
+}
+
+static thread_local long long	allocations = 0;
+
+//-------------------------------------------------------------------------------------------------
+
+static void* allocate ( std::size_t size ) noexcept
+{
+	++allocations;
+
+	return std::malloc ( size > 0 ? size : 1 );
+}
+//-------------------------------------------------------------------------------------------------
+
+static void* allocateAligned ( std::size_t size, std::align_val_t alignment ) noexcept
+{
+	++allocations;
+
+	size = size > 0 ? size : 1;
+
+#ifdef _WIN32
+	return _aligned_malloc ( size, std::size_t ( alignment ) );
+#else
+	void*	p = nullptr;
+
+	return posix_memalign ( &p, std::max ( std::size_t ( alignment ), sizeof ( void* ) ), size ) == 0 ? p : nullptr;
+#endif
+}
+//-------------------------------------------------------------------------------------------------
+
+static void freeAligned ( void* p ) noexcept
+{
+#ifdef _WIN32
+	_aligned_free ( p );
+#else
+	std::free ( p );
+#endif
+}
+//-------------------------------------------------------------------------------------------------
+
+void* operator new ( std::size_t size )
+{
+	if ( auto p = allocate ( size ) )
+		return p;
+
+	throw std::bad_alloc ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void* operator new ( std::size_t size, std::align_val_t alignment )
+{
+	if ( auto p = allocateAligned ( size, alignment ) )
+		return p;
+
+	throw std::bad_alloc ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void* operator new[] ( std::size_t size )															{ return operator new ( size ); }
+void* operator new[] ( std::size_t size, std::align_val_t alignment )								{ return operator new ( size, alignment ); }
+void* operator new ( std::size_t size, const std::nothrow_t& ) noexcept								{ return allocate ( size ); }
+void* operator new[] ( std::size_t size, const std::nothrow_t& ) noexcept							{ return allocate ( size ); }
+void* operator new ( std::size_t size, std::align_val_t alignment, const std::nothrow_t& ) noexcept	{ return allocateAligned ( size, alignment ); }
+void* operator new[] ( std::size_t size, std::align_val_t alignment, const std::nothrow_t& ) noexcept	{ return allocateAligned ( size, alignment ); }
+
+void operator delete ( void* p ) noexcept															{ std::free ( p ); }
+void operator delete[] ( void* p ) noexcept															{ std::free ( p ); }
+void operator delete ( void* p, std::size_t ) noexcept												{ std::free ( p ); }
+void operator delete[] ( void* p, std::size_t ) noexcept											{ std::free ( p ); }
+void operator delete ( void* p, const std::nothrow_t& ) noexcept									{ std::free ( p ); }
+void operator delete[] ( void* p, const std::nothrow_t& ) noexcept									{ std::free ( p ); }
+void operator delete ( void* p, std::align_val_t ) noexcept											{ freeAligned ( p ); }
+void operator delete[] ( void* p, std::align_val_t ) noexcept										{ freeAligned ( p ); }
+void operator delete ( void* p, std::size_t, std::align_val_t ) noexcept							{ freeAligned ( p ); }
+void operator delete[] ( void* p, std::size_t, std::align_val_t ) noexcept							{ freeAligned ( p ); }
+void operator delete ( void* p, std::align_val_t, const std::nothrow_t& ) noexcept					{ freeAligned ( p ); }
+void operator delete[] ( void* p, std::align_val_t, const std::nothrow_t& ) noexcept				{ freeAligned ( p ); }
+
+//-------------------------------------------------------------------------------------------------
+
+// The benchmarks read the counter through this, they are compiled before it is known to exist
+static const bool	counterInstalled = []
+{
+	reFX::allocationsOnThisThread = [] { return allocations; };
+	return true;
+} ();
@@ -0,0 +1,111 @@
+#include "refx_LogCategory.h"
+
+//-------------------------------------------------------------------------------------------------
+
+namespace reFX
+{
+
+LogCategory::LogCategory ( const juce::String& n, LogCategory* p )
+	: name ( n )
+	, parent ( p )
+{
+}
+//-------------------------------------------------------------------------------------------------
+
+LogCategory::Registry& LogCategory::registry ()
+{
+	// Never destroyed, call sites in static objects may still log during shutdown
+	static auto	r = new Registry ();
+	return *r;
+}
+//-------------------------------------------------------------------------------------------------
+
+LogCategory& LogCategory::get ( const juce::String& name )
+{
+	auto&	r = registry ();
+
+	juce::ScopedLock	sl ( r.lock );
+
+	for ( auto& c : r.categories )
+		if ( c->name == name )
+			return *c;
+
+	LogCategory*	parent = nullptr;
+
+	if ( name.containsChar ( '.' ) )
+		parent = &get ( name.upToLastOccurrenceOf ( ".", false, false ) );
+
+	r.categories.push_back ( std::unique_ptr<LogCategory> ( new LogCategory ( name, parent ) ) );
+	updateLevels ();
+
+	return *r.categories.back ();
+}
+//-------------------------------------------------------------------------------------------------
+
+std::vector<LogCategory*> LogCategory::getAll ()
+{
+	auto&	r = registry ();
+
+	juce::ScopedLock	sl ( r.lock );
+
+	std::vector<LogCategory*>	all;
+
+	for ( auto& c : r.categories )
+		all.push_back ( c.get () );
+
+	return all;
+}
+//-------------------------------------------------------------------------------------------------
+
+bool LogCategory::isWithin ( const LogCategory& other ) const
+{
+	for ( auto c = this; c != nullptr; c = c->parent )
+		if ( c == &other )
+			return true;
+
+	return false;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogCategory::setLevel ( LogLevel l )
+{
+	juce::ScopedLock	sl ( registry ().lock );
+
+	ownLevel = int ( l );
+	updateLevels ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogCategory::inheritLevel ()
+{
+	juce::ScopedLock	sl ( registry ().lock );
+
+	ownLevel = -1;
+	updateLevels ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogCategory::updateLevels ()
+{
+	auto&	r = registry ();
+
+	juce::ScopedLock	sl ( r.lock );
+
+	// Parents were created first, so their levels are already resolved
+	for ( auto& c : r.categories )
+	{
+		const auto	own = c->ownLevel.load ();
+
+		if ( own >= 0 )
+			c->effectiveLevel = own;
+		else if ( c->parent != nullptr )
+			c->effectiveLevel = c->parent->effectiveLevel.load ();
+		else
+			c->effectiveLevel = Logging::activeLevel.load ();
+	}
+
+	++r.generation;
+}
+//-------------------------------------------------------------------------------------------------
+
+}
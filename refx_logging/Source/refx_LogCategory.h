@@ -0,0 +1,64 @@
+#pragma once
+
+namespace reFX
+{
+//-------------------------------------------------------------------------------------------------
+// Named categories like "audio.engine", see Z_INFO_C. Every category can have a minimum level of
+// its own, otherwise it follows its parent, and the top level ones follow Logging::setLogLevel.
+// The resolved level is kept in an atomic, and each call site looks its category up only once,
+// so checking a message costs one atomic load. Categories live until the program ends.
+
+class LogCategory
+{
+public:
+	// Creates the category and its parents on first use. Names are case sensitive.
+	static LogCategory& get ( const juce::String& name );
+
+	// Parents come before their children
+	static std::vector<LogCategory*> getAll ();
+
+	// Changes whenever a level changes, for views that filter by level
+	static int getGeneration ()							{ return registry ().generation.load (); }
+
+	const juce::String& getName () const				{ return name; }
+	LogCategory* getParent () const						{ return parent; }
+	bool isWithin ( const LogCategory& ) const;			// True for the category itself and its children
+
+	bool isEnabled ( LogLevel l ) const noexcept		{ return int ( l ) >= effectiveLevel.load ( std::memory_order_relaxed ); }
+	LogLevel getLevel () const							{ return LogLevel ( effectiveLevel.load () ); }
+
+	bool hasOwnLevel () const							{ return ownLevel.load () >= 0; }
+	LogLevel getOwnLevel () const						{ return LogLevel ( juce::jmax ( 0, ownLevel.load () ) ); }
+	void setLevel ( LogLevel );
+	void inheritLevel ();
+
+private:
+	friend class Logging;
+
+	struct Registry
+	{
+		juce::CriticalSection						lock;
+		std::vector<std::unique_ptr<LogCategory>>	categories;
+		std::atomic<int>							generation { 0 };
+	};
+
+	LogCategory ( const juce::String& name, LogCategory* parent );
+
+	static Registry& registry ();
+	static void updateLevels ();
+
+	juce::String		name;
+	LogCategory*		parent;
+	std::atomic<int>	ownLevel { -1 };			// -1 inherits
+	std::atomic<int>	effectiveLevel { 0 };
+
+	JUCE_DECLARE_NON_COPYABLE ( LogCategory )
+};
+//-------------------------------------------------------------------------------------------------
+
+inline bool LogCallSite::isLevelEnabled ( LogLevel l ) const noexcept
+{
+	return category != nullptr ? category->isEnabled ( l ) : Logging::isLevelEnabled ( l );
+}
+//-------------------------------------------------------------------------------------------------
+}
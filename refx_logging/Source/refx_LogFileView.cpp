@@ -0,0 +1,237 @@
+#include "refx_LogFileView.h"
+#include "refx_BinaryLogFormat.h"
+#include "refx_MappedLogFile.h"
+
+//-------------------------------------------------------------------------------------------------
+
+namespace reFX
+{
+
+LogFileView::LogFileView ( const juce::File& f )
+	: juce::Thread ( "reFX log file index" )
+	, file ( f )
+{
+	startThread ( juce::Thread::Priority::low );
+}
+//-------------------------------------------------------------------------------------------------
+
+LogFileView::~LogFileView ()
+{
+	stopThread ( 10000 );
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String LogFileView::getLine ( int index, LogLevel& level )
+{
+	level = LogLevel::log;
+
+	juce::ScopedLock	sl ( lock );
+
+	if ( mapped == nullptr || ! juce::isPositiveAndBelow ( index, numLines.load () ) )
+		return {};
+
+	auto	pos = checkpoints[ size_t ( index / linesPerCheckpoint ) ];
+
+	if ( binary )
+	{
+		// Damaged data is skipped the same way the indexer skipped it
+		juce::MemoryInputStream	in ( data, size_t ( size ), false );
+		in.setPosition ( pos );
+
+		BinaryLogFormat::RecordReader	reader ( in );
+		LogMessage						msg;
+
+		for ( int i = index % linesPerCheckpoint; i >= 0; --i )
+			if ( ! reader.read ( msg ) )
+				return {};
+
+		level = msg.level;
+
+		return msg.toString ();
+	}
+
+	for ( int i = index % linesPerCheckpoint; --i >= 0; )
+	{
+		const auto	nl = static_cast<const char*> ( std::memchr ( data + pos, '\n', size_t ( size - pos ) ) );
+		pos = nl != nullptr ? nl - data + 1 : size;
+	}
+
+	const auto	nl = static_cast<const char*> ( std::memchr ( data + pos, '\n', size_t ( size - pos ) ) );
+	auto		length = ( nl != nullptr ? nl - data : size ) - pos;
+
+	if ( length > 0 && data[ pos + length - 1 ] == '\r' )
+		--length;
+
+	// Nobody reads a megabyte in one row, cut at a character boundary
+	constexpr juce::int64	maxLength = 16384;
+
+	if ( length > maxLength )
+	{
+		length = maxLength;
+
+		while ( length > 0 && ( juce::uint8 ( data[ pos + length ] ) & 0xc0 ) == 0x80 )
+			--length;
+	}
+
+	const auto	line = juce::String::fromUTF8 ( data + pos, int ( length ) );
+
+	level = parseLevel ( line );
+
+	return line;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogFileView::run ()
+{
+	if ( ! map () )
+		failed = true;
+	else if ( binary )
+		indexBinary ();
+	else
+		indexText ();
+
+	indexing = false;
+}
+//-------------------------------------------------------------------------------------------------
+
+bool LogFileView::map ()
+{
+	auto	source = file;
+
+	if ( file.hasFileExtension ( BinaryLogFormat::compressedFileExtension ) )
+	{
+		auto	temp = std::make_unique<juce::TemporaryFile> ();
+
+		{
+			juce::FileInputStream	in ( file );
+			juce::FileOutputStream	out ( temp->getFile () );
+
+			if ( ! in.openedOk () || ! out.openedOk () )
+				return false;
+
+			juce::GZIPDecompressorInputStream	gz ( &in, false, juce::GZIPDecompressorInputStream::gzipFormat );
+			juce::HeapBlock<char>				buffer ( 65536 );
+
+			for ( int n; ( n = gz.read ( buffer, 65536 ) ) > 0; )
+			{
+				if ( threadShouldExit () )
+					return false;
+
+				out.write ( buffer, size_t ( n ) );
+			}
+		}
+
+		source = temp->getFile ();
+		decompressed = std::move ( temp );
+	}
+
+	auto	m = std::make_unique<juce::MemoryMappedFile> ( source, juce::MemoryMappedFile::readOnly );
+
+	// Empty files cannot be mapped, but are fine to show
+	if ( m->getData () == nullptr )
+		return source.existsAsFile () && source.getSize () == 0;
+
+	auto	start = static_cast<const char*> ( m->getData () );
+	auto	length = juce::int64 ( m->getSize () );
+
+	// Only the committed part of a mapped log file, the rest may be unused zeros
+	if ( const auto end = MappedLogFile::readCommittedEnd ( start, size_t ( length ) ) )
+	{
+		length = std::min ( *end, length ) - MappedLogFile::headerSize;
+		start += MappedLogFile::headerSize;
+	}
+
+	juce::MemoryInputStream	header ( start, size_t ( length ), false );
+	const auto				isBinary = BinaryLogFormat::isBinaryLog ( header );
+	juce::uint32			fileVersion;
+
+	// Records of a newer version may be laid out differently
+	if ( isBinary && ! BinaryLogFormat::readVersion ( header, fileVersion ) )
+		return false;
+
+	juce::ScopedLock	sl ( lock );
+
+	mapped = std::move ( m );
+	data = start;
+	size = length;
+	binary = isBinary;
+
+	return true;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogFileView::indexText ()
+{
+	juce::int64	pos = 0;
+	auto		lines = 0;
+
+	while ( pos < size && ! threadShouldExit () )
+	{
+		addCheckpoint ( pos, lines );
+
+		const auto	nl = static_cast<const char*> ( std::memchr ( data + pos, '\n', size_t ( size - pos ) ) );
+		pos = nl != nullptr ? nl - data + 1 : size;
+
+		// Publishing in steps keeps the list box from updating for every line
+		if ( ++lines % 4096 == 0 )
+			numLines = lines;
+	}
+
+	numLines = lines;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogFileView::indexBinary ()
+{
+	juce::MemoryInputStream	in ( data, size_t ( size ), false );
+	in.setPosition ( BinaryLogFormat::fileHeaderSize );
+
+	BinaryLogFormat::RecordReader	reader ( in );
+	auto							lines = 0;
+
+	for ( LogMessage msg; ! threadShouldExit (); )
+	{
+		addCheckpoint ( reader.getPosition (), lines );
+
+		if ( ! reader.read ( msg ) )
+			break;
+
+		if ( ++lines % 4096 == 0 )
+			numLines = lines;
+	}
+
+	numLines = lines;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogFileView::addCheckpoint ( juce::int64 position, int lineCount )
+{
+	if ( lineCount % linesPerCheckpoint != 0 || size_t ( lineCount / linesPerCheckpoint ) < checkpoints.size () )
+		return;
+
+	juce::ScopedLock	sl ( lock );
+
+	checkpoints.push_back ( position );
+}
+//-------------------------------------------------------------------------------------------------
+
+LogLevel LogFileView::parseLevel ( const juce::String& line )
+{
+	// HH:MM:SS.uuuuuu: CODE [thread] - text, see LogMessage::writeTo
+	const auto	codeStart = line.indexOf ( ": " );
+
+	if ( codeStart < 0 )
+		return LogLevel::log;
+
+	const auto	code = line.substring ( codeStart + 2, codeStart + 6 );
+
+	if ( code == "ERR " )	return LogLevel::error;
+	if ( code == "WARN" )	return LogLevel::warning;
+	if ( code == "INFO" )	return LogLevel::info;
+	if ( code == "DLOG" )	return LogLevel::debuglog;
+
+	return LogLevel::log;
+}
+//-------------------------------------------------------------------------------------------------
+
+}
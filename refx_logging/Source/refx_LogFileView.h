@@ -0,0 +1,58 @@
+#pragma once
+
+namespace reFX
+{
+//-------------------------------------------------------------------------------------------------
+// Read-only view of a log file for the logging window. The file is memory-mapped and a background
+// thread indexes its lines (records for binary logs), so opening is instant. Only every
+// linesPerCheckpoint-th line start is stored and a line is found by scanning forward from the
+// nearest checkpoint. The index still grows with the file, by 8 bytes per linesPerCheckpoint
+// lines, about 1 MB for 8 million lines. Gzipped files are decompressed into a temporary file first.
+
+class LogFileView
+	: private juce::Thread
+{
+public:
+	explicit LogFileView ( const juce::File& );
+	~LogFileView () override;
+
+	const juce::File& getFile () const		{ return file; }
+
+	bool isIndexing () const				{ return indexing; }
+	bool failedToOpen () const				{ return failed; }
+
+	// Grows while the file is being indexed
+	int getNumLines () const				{ return numLines; }
+
+	// Text of a line as the log file has it and the level of the message on it
+	juce::String getLine ( int index, LogLevel& level );
+
+private:
+	static constexpr int	linesPerCheckpoint = 64;
+
+	void run () override;
+	bool map ();
+	void indexText ();
+	void indexBinary ();
+	void addCheckpoint ( juce::int64 position, int lineCount );
+
+	static LogLevel parseLevel ( const juce::String& line );
+
+	const juce::File						file;
+	std::unique_ptr<juce::TemporaryFile>	decompressed;
+
+	juce::CriticalSection					lock;
+	std::unique_ptr<juce::MemoryMappedFile>	mapped;
+	const char*								data = nullptr;		// Log data in the mapping, after the header of mapped log files
+	juce::int64								size = 0;
+	bool									binary = false;
+	std::vector<juce::int64>				checkpoints;	// Start of every linesPerCheckpoint-th line
+
+	std::atomic<int>						numLines { 0 };
+	std::atomic<bool>						indexing { true };
+	std::atomic<bool>						failed { false };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR ( LogFileView )
+};
+//-------------------------------------------------------------------------------------------------
+}
@@ -0,0 +1,143 @@
+#include "refx_LogFolderIndex.h"
+#include "refx_BinaryLogFormat.h"
+
+//-------------------------------------------------------------------------------------------------
+
+namespace reFX
+{
+
+static bool isLogFile ( const juce::File& f )
+{
+	// Compressed files are <name>.txt.gz or <name>.rlog.gz
+	const auto	plain = f.hasFileExtension ( BinaryLogFormat::compressedFileExtension ) ? f.getFileNameWithoutExtension () : f.getFileName ();
+
+	return plain.endsWithIgnoreCase ( ".txt" ) || plain.endsWithIgnoreCase ( BinaryLogFormat::fileExtension );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogFolderIndex::scan ( const juce::File& folder )
+{
+	std::vector<Entry>	found;
+
+	// Other files that share the folder are neither listed nor expired
+	for ( const auto& f : folder.findChildFiles ( juce::File::findFiles, false ) )
+		if ( isLogFile ( f ) )
+			found.push_back ( { f, f.getCreationTime (), f.getSize () } );
+
+	std::sort ( found.begin (), found.end (), [] ( const auto& lhs, const auto& rhs ) { return lhs.created < rhs.created; } );
+
+	juce::ScopedLock	sl ( lock );
+
+	entries = std::move ( found );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogFolderIndex::clear ()
+{
+	juce::ScopedLock	sl ( lock );
+
+	entries.clear ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogFolderIndex::add ( const juce::File& f )
+{
+	juce::ScopedLock	sl ( lock );
+
+	// New files are always the newest ones
+	entries.push_back ( { f, juce::Time::getCurrentTime (), f.getSize () } );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogFolderIndex::setSize ( const juce::File& f, juce::int64 size )
+{
+	juce::ScopedLock	sl ( lock );
+
+	for ( auto& e : entries )
+		if ( e.file == f )
+			e.size = size;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogFolderIndex::remove ( const juce::File& f )
+{
+	juce::ScopedLock	sl ( lock );
+
+	entries.erase ( std::remove_if ( entries.begin (), entries.end (), [ & ] ( const auto& e ) { return e.file == f; } ), entries.end () );
+}
+//-------------------------------------------------------------------------------------------------
+
+bool LogFolderIndex::replace ( const juce::File& oldFile, const juce::File& newFile, juce::int64 newSize )
+{
+	juce::ScopedLock	sl ( lock );
+
+	for ( auto& e : entries )
+	{
+		if ( e.file == oldFile )
+		{
+			e.file = newFile;
+			e.size = newSize;
+			return true;
+		}
+	}
+
+	return false;
+}
+//-------------------------------------------------------------------------------------------------
+
+std::vector<LogFolderIndex::Entry> LogFolderIndex::getEntries ()
+{
+	juce::ScopedLock	sl ( lock );
+
+	return entries;
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::int64 LogFolderIndex::getTotalSize ()
+{
+	juce::ScopedLock	sl ( lock );
+
+	juce::int64	total = 0;
+
+	for ( const auto& e : entries )
+		total += e.size;
+
+	return total;
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::Array<juce::File> LogFolderIndex::removeExpired ( int maxFiles, juce::int64 maxTotalBytes, const juce::File& keep )
+{
+	juce::ScopedLock	sl ( lock );
+
+	juce::Array<juce::File>	expired;
+
+	auto	total = juce::int64 ( 0 );
+
+	for ( const auto& e : entries )
+		total += e.size;
+
+	for ( auto it = entries.begin (); it != entries.end (); )
+	{
+		const auto	tooMany = maxFiles > 0 && int ( entries.size () ) > maxFiles;
+		const auto	tooLarge = maxTotalBytes > 0 && total > maxTotalBytes;
+
+		if ( ! tooMany && ! tooLarge )
+			break;
+
+		if ( it->file == keep )
+		{
+			++it;
+			continue;
+		}
+
+		total -= it->size;
+		expired.add ( it->file );
+		it = entries.erase ( it );
+	}
+
+	return expired;
+}
+//-------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+namespace reFX
+{
+//-------------------------------------------------------------------------------------------------
+// The log files in the log folder, oldest first. The folder is scanned once, after that the
+// index is kept up to date by the writer, so nobody has to list the folder or query creation
+// times again.
+
+class LogFolderIndex
+{
+public:
+	struct Entry
+	{
+		juce::File		file;
+		juce::Time		created;
+		juce::int64		size = 0;
+	};
+
+	void scan ( const juce::File& folder );
+	void clear ();
+
+	void add ( const juce::File& );
+	void setSize ( const juce::File&, juce::int64 size );
+	void remove ( const juce::File& );
+
+	// Returns false if the old file is not in the index anymore
+	bool replace ( const juce::File& oldFile, const juce::File& newFile, juce::int64 newSize );
+
+	std::vector<Entry> getEntries ();
+	juce::int64 getTotalSize ();
+
+	// Removes the oldest entries beyond the limits from the index and returns their files.
+	// The file passed as keep is never expired, 0 disables a limit.
+	juce::Array<juce::File> removeExpired ( int maxFiles, juce::int64 maxTotalBytes, const juce::File& keep );
+
+private:
+	juce::CriticalSection	lock;
+	std::vector<Entry>		entries;
+};
+//-------------------------------------------------------------------------------------------------
+}
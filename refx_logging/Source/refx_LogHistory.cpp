@@ -0,0 +1,79 @@
+#include "refx_LogHistory.h"
+
+//-------------------------------------------------------------------------------------------------
+
+namespace reFX
+{
+
+LogHistory::LogHistory ( int capacity )
+	: slots ( size_t ( juce::jmax ( 1, capacity ) ) )
+{
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogHistory::takeNewest ( LogHistory& other )
+{
+	const auto	keep = juce::jmin ( other.size (), getCapacity () );
+
+	for ( int i = 0; i < keep; ++i )
+		slots[ size_t ( i ) ] = std::move ( other.slots[ ( other.first + size_t ( other.size () - keep + i ) ) % other.slots.size () ] );
+
+	first = 0;
+	count = size_t ( keep );
+
+	other.clear ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogHistory::clear ()
+{
+	first = 0;
+	count = 0;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogHistory::add ( const LogMessage& msg )
+{
+	if ( count < slots.size () )
+	{
+		slots[ ( first + count ) % slots.size () ] = msg;
+		++count;
+	}
+	else
+	{
+		// Full, the oldest slot becomes the newest
+		slots[ first ] = msg;
+		first = ( first + 1 ) % slots.size ();
+	}
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::Array<LogMessage> LogHistory::getMessages () const
+{
+	juce::Array<LogMessage>	result;
+	result.ensureStorageAllocated ( size () );
+
+	for ( int i = 0; i < size (); ++i )
+		result.add ( ( *this )[ i ] );
+
+	return result;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogHistory::getMessagesAfter ( juce::uint64 sequence, juce::Array<LogMessage>& dest ) const
+{
+	if ( count == 0 || sequence >= getNewestSequence () )
+		return;
+
+	// Sequence numbers are contiguous, so the start is found without searching
+	const auto	oldest = getOldestSequence ();
+	const auto	start = sequence < oldest ? 0 : int ( sequence - oldest + 1 );
+
+	dest.ensureStorageAllocated ( dest.size () + size () - start );
+
+	for ( int i = start; i < size (); ++i )
+		dest.add ( ( *this )[ i ] );
+}
+//-------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+namespace reFX
+{
+//-------------------------------------------------------------------------------------------------
+// Fixed capacity ring of the most recent messages. Slots are preallocated, adding a message
+// overwrites the oldest one once the ring is full. Not thread safe, Logging guards it.
+
+class LogHistory
+{
+public:
+	explicit LogHistory ( int capacity );
+
+	// Moves over the newest messages of another history that fit, which is left empty. Resizing
+	// builds a new history outside the lock and only moves the messages under it.
+	void takeNewest ( LogHistory& );
+	int getCapacity () const							{ return int ( slots.size () ); }
+
+	int size () const									{ return int ( count ); }
+	bool isEmpty () const								{ return count == 0; }
+
+	// Only forgets the messages, they are freed when their slots are overwritten
+	void clear ();
+
+	void add ( const LogMessage& );
+
+	// 0 is the oldest retained message
+	const LogMessage& operator[] ( int index ) const	{ return slots[ ( first + size_t ( index ) ) % slots.size () ]; }
+
+	// Sequence numbers of the oldest and newest retained messages, 0 if empty
+	juce::uint64 getOldestSequence () const				{ return count > 0 ? ( *this )[ 0 ].sequence : 0; }
+	juce::uint64 getNewestSequence () const				{ return count > 0 ? ( *this )[ size () - 1 ].sequence : 0; }
+
+	juce::Array<LogMessage> getMessages () const;
+
+	// Appends the retained messages newer than the given sequence number
+	void getMessagesAfter ( juce::uint64 sequence, juce::Array<LogMessage>& dest ) const;
+
+private:
+	std::vector<LogMessage>	slots;
+	size_t					first = 0;
+	size_t					count = 0;
+};
+//-------------------------------------------------------------------------------------------------
+}
@@ -0,0 +1,73 @@
+#include "refx_LogHousekeeper.h"
+
+//-------------------------------------------------------------------------------------------------
+
+namespace reFX
+{
+
+LogHousekeeper::LogHousekeeper ()
+	: juce::Thread ( "reFX log housekeeping" )
+{
+}
+//-------------------------------------------------------------------------------------------------
+
+LogHousekeeper::~LogHousekeeper ()
+{
+	signalThreadShouldExit ();
+	wakeUp.signal ();
+	stopThread ( 10000 );
+
+	// Finish what the thread did not get to
+	while ( runNextJob () )
+		;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogHousekeeper::addJob ( std::function<void ()> job )
+{
+	{
+		juce::ScopedLock	sl ( lock );
+
+		jobs.push_back ( std::move ( job ) );
+	}
+
+	if ( ! isThreadRunning () )
+		startThread ( juce::Thread::Priority::background );
+
+	wakeUp.signal ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogHousekeeper::run ()
+{
+	while ( ! threadShouldExit () )
+	{
+		while ( ! threadShouldExit () && runNextJob () )
+			;
+
+		wakeUp.wait ( -1.0 );
+	}
+}
+//-------------------------------------------------------------------------------------------------
+
+bool LogHousekeeper::runNextJob ()
+{
+	std::function<void ()>	job;
+
+	{
+		juce::ScopedLock	sl ( lock );
+
+		if ( jobs.empty () )
+			return false;
+
+		job = std::move ( jobs.front () );
+		jobs.pop_front ();
+	}
+
+	job ();
+
+	return true;
+}
+//-------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <deque>
+
+namespace reFX
+{
+//-------------------------------------------------------------------------------------------------
+// Low priority thread for slow file maintenance, so producers never wait for it
+
+class LogHousekeeper
+	: private juce::Thread
+{
+public:
+	LogHousekeeper ();
+	~LogHousekeeper () override;
+
+	void addJob ( std::function<void ()> );
+
+private:
+	void run () override;
+	bool runNextJob ();
+
+	juce::CriticalSection				lock;
+	std::deque<std::function<void ()>>	jobs;
+	juce::WaitableEvent					wakeUp;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR ( LogHousekeeper )
+};
+//-------------------------------------------------------------------------------------------------
+}
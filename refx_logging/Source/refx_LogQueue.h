@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+
+namespace reFX
+{
+//-------------------------------------------------------------------------------------------------
+// Bounded lock-free queue with a fixed number of preallocated slots (D. Vyukov's MPMC design).
+// Any number of threads may push and pop, the logging pipeline uses it with many producers
+// and one consumer at a time. Capacity must be a power of two.
+
+template <typename T>
+class LogQueue
+{
+public:
+	explicit LogQueue ( int capacity )
+		: slots ( new Slot[ size_t ( capacity ) ] ), mask ( size_t ( capacity ) - 1 )
+	{
+		jassert ( capacity > 1 && ( capacity & ( capacity - 1 ) ) == 0 );
+
+		for ( size_t i = 0; i <= mask; ++i )
+			slots[ i ].sequence.store ( i, std::memory_order_relaxed );
+	}
+
+	int getCapacity () const		{ return int ( mask + 1 ); }
+
+	// Returns false if the queue is full
+	template <typename U>
+	bool push ( U&& value )
+	{
+		auto	pos = enqueuePos.load ( std::memory_order_relaxed );
+
+		for (;;)
+		{
+			auto&		slot = slots[ pos & mask ];
+			const auto	seq = slot.sequence.load ( std::memory_order_acquire );
+			const auto	diff = std::intptr_t ( seq ) - std::intptr_t ( pos );
+
+			if ( diff == 0 )
+			{
+				if ( enqueuePos.compare_exchange_weak ( pos, pos + 1, std::memory_order_relaxed ) )
+				{
+					slot.value = std::forward<U> ( value );
+					slot.sequence.store ( pos + 1, std::memory_order_release );
+					return true;
+				}
+			}
+			else if ( diff < 0 )
+			{
+				return false;
+			}
+			else
+			{
+				pos = enqueuePos.load ( std::memory_order_relaxed );
+			}
+		}
+	}
+
+	// Returns false if there is nothing to pop
+	bool pop ( T& value )
+	{
+		auto	pos = dequeuePos.load ( std::memory_order_relaxed );
+
+		for (;;)
+		{
+			auto&		slot = slots[ pos & mask ];
+			const auto	seq = slot.sequence.load ( std::memory_order_acquire );
+			const auto	diff = std::intptr_t ( seq ) - std::intptr_t ( pos + 1 );
+
+			if ( diff == 0 )
+			{
+				if ( dequeuePos.compare_exchange_weak ( pos, pos + 1, std::memory_order_relaxed ) )
+				{
+					value = std::move ( slot.value );
+					slot.sequence.store ( pos + mask + 1, std::memory_order_release );
+					return true;
+				}
+			}
+			else if ( diff < 0 )
+			{
+				return false;
+			}
+			else
+			{
+				pos = dequeuePos.load ( std::memory_order_relaxed );
+			}
+		}
+	}
+
+	// Approximate while producers are active, includes slots that are claimed but not yet published
+	int getNumQueued () const
+	{
+		const auto	head = dequeuePos.load ( std::memory_order_acquire );
+		const auto	tail = enqueuePos.load ( std::memory_order_acquire );
+
+		return tail > head ? int ( tail - head ) : 0;
+	}
+
+	bool isEmpty () const			{ return getNumQueued () == 0; }
+
+private:
+	struct Slot
+	{
+		std::atomic<size_t>	sequence { 0 };
+		T					value {};
+	};
+
+	std::unique_ptr<Slot[]>			slots;
+	const size_t					mask;
+
+	alignas ( 64 ) std::atomic<size_t>	enqueuePos { 0 };
+	alignas ( 64 ) std::atomic<size_t>	dequeuePos { 0 };
+
+	JUCE_DECLARE_NON_COPYABLE ( LogQueue )
+};
+//-------------------------------------------------------------------------------------------------
+}
@@ -0,0 +1,91 @@
+#include "refx_LogRowCache.h"
+
+//-------------------------------------------------------------------------------------------------
+
+namespace reFX
+{
+
+LogRowCache::LogRowCache ( int maxRows_ )
+	: maxRows ( juce::jmax ( 1, maxRows_ ) )
+{
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String LogRowCache::formatRow ( const LogMessage& message )
+{
+	return message.getTimeString () + " - " + message.description;
+}
+//-------------------------------------------------------------------------------------------------
+
+const LogRowCache::Row& LogRowCache::getRow ( const LogMessage& message, const juce::Font& font, float scale )
+{
+	return getRow ( message.sequence, font, scale, [ &message ] { return formatRow ( message ); } );
+}
+//-------------------------------------------------------------------------------------------------
+
+const LogRowCache::Row& LogRowCache::getRow ( juce::uint64 sequence, const juce::String& text, const juce::Font& font, float scale )
+{
+	return getRow ( sequence, font, scale, [ &text ] { return text; } );
+}
+//-------------------------------------------------------------------------------------------------
+
+template <typename MakeText>
+const LogRowCache::Row& LogRowCache::getRow ( juce::uint64 sequence, const juce::Font& font, float scale, MakeText&& makeText )
+{
+	const Key	key = { sequence, getFontIndex ( font ), scale };
+
+	if ( auto it = lookup.find ( key ); it != lookup.end () )
+	{
+		rows.splice ( rows.begin (), rows, it->second );
+		return it->second->second;
+	}
+
+	rows.emplace_front ( key, Row () );
+
+	auto&	row = rows.front ().second;
+	row.text = makeText ();
+	row.width = juce::GlyphArrangement::getStringWidth ( font, row.text );
+	row.glyphs.addLineOfText ( font, row.text, 0.0f, 0.0f );
+
+	lookup[ key ] = rows.begin ();
+
+	while ( int ( rows.size () ) > maxRows )
+	{
+		lookup.erase ( rows.back ().first );
+		rows.pop_back ();
+	}
+
+	return row;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogRowCache::clear ()
+{
+	lookup.clear ();
+	rows.clear ();
+	fonts.clear ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogRowCache::drawRow ( juce::Graphics& g, const Row& row, const juce::Font& font, float x, int height )
+{
+	const auto	baseline = ( float ( height ) - font.getHeight () ) * 0.5f + font.getAscent ();
+
+	row.glyphs.draw ( g, juce::AffineTransform::translation ( x, baseline ) );
+}
+//-------------------------------------------------------------------------------------------------
+
+int LogRowCache::getFontIndex ( const juce::Font& font )
+{
+	// Only a handful of fonts are ever used, a linear search is fine
+	for ( size_t i = 0; i < fonts.size (); ++i )
+		if ( fonts[ i ] == font )
+			return int ( i );
+
+	fonts.push_back ( font );
+
+	return int ( fonts.size () ) - 1;
+}
+//-------------------------------------------------------------------------------------------------
+
+}
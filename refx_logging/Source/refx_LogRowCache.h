@@ -0,0 +1,70 @@
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+namespace reFX
+{
+//-------------------------------------------------------------------------------------------------
+// Formatted and laid out rows for the logging views, built once per message, font and scale.
+// Shared by LoggingWindow and LoggingComponent, message thread only.
+
+class LogRowCache
+{
+public:
+	struct Row
+	{
+		juce::String			text;
+		float					width = 0.0f;
+		juce::GlyphArrangement	glyphs;			// Laid out with the baseline at y = 0
+	};
+
+	explicit LogRowCache ( int maxRows = 4096 );
+
+	const Row& getRow ( const LogMessage&, const juce::Font&, float scale );
+
+	// Rows that are not made from a LogMessage, e.g. lines of a log file. The keys must not collide
+	// with the sequence numbers of other rows in the same cache.
+	const Row& getRow ( juce::uint64 key, const juce::String& text, const juce::Font&, float scale );
+
+	void clear ();
+
+	static juce::String formatRow ( const LogMessage& );
+
+	// Draws a cached row vertically centred, with the given left inset
+	static void drawRow ( juce::Graphics&, const Row&, const juce::Font&, float x, int height );
+
+private:
+	struct Key
+	{
+		juce::uint64	sequence;
+		int				font;
+		float			scale;
+
+		bool operator== ( const Key& o ) const	{ return sequence == o.sequence && font == o.font && scale == o.scale; }
+	};
+
+	struct KeyHash
+	{
+		size_t operator() ( const Key& k ) const
+		{
+			return std::hash<juce::uint64> () ( k.sequence ) ^ ( std::hash<int> () ( k.font ) << 1 ) ^ ( std::hash<float> () ( k.scale ) << 2 );
+		}
+	};
+
+	using Entry = std::pair<Key, Row>;
+
+	template <typename MakeText>
+	const Row& getRow ( juce::uint64 key, const juce::Font&, float scale, MakeText&& );
+
+	int getFontIndex ( const juce::Font& );
+
+	const int														maxRows;
+	std::list<Entry>												rows;		// Most recently used first
+	std::unordered_map<Key, std::list<Entry>::iterator, KeyHash>	lookup;
+	std::vector<juce::Font>											fonts;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR ( LogRowCache )
+};
+//-------------------------------------------------------------------------------------------------
+}
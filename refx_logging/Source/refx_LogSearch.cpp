@@ -0,0 +1,347 @@
+#include "refx_LogSearch.h"
+
+//-------------------------------------------------------------------------------------------------
+
+namespace reFX
+{
+
+LogSearch::LogSearch ( Logging& l )
+	: juce::Thread ( "reFX log search" )
+	, logging ( l )
+{
+	startThread ( juce::Thread::Priority::low );
+}
+//-------------------------------------------------------------------------------------------------
+
+LogSearch::~LogSearch ()
+{
+	signalThreadShouldExit ();
+	wakeUp.signal ();
+	stopThread ( 10000 );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSearch::setQuery ( const juce::String& text, bool isRegex )
+{
+	int	g;
+
+	{
+		juce::ScopedLock	sl ( queryLock );
+
+		pendingText = text;
+		pendingRegex = isRegex;
+		g = ++generation;
+	}
+
+	{
+		juce::ScopedLock	rl ( resultLock );
+
+		results.clearQuick ();
+		resultGeneration = g;
+	}
+
+	searching = text.isNotEmpty ();
+	wakeUp.signal ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSearch::messagesAdded ()
+{
+	wakeUp.signal ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSearch::takeResults ( juce::Array<LogMessage>& dest )
+{
+	juce::ScopedLock	rl ( resultLock );
+
+	dest.addArray ( results );
+	results.clearQuick ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSearch::run ()
+{
+	while ( ! threadShouldExit () )
+	{
+		wakeUp.wait ( -1.0 );
+
+		juce::uint64	firstNew = 0;
+
+		pullNewMessages ( firstNew );
+		evictExpired ();
+
+		// A new query goes through everything, otherwise only new messages are checked
+		if ( generation.load () != query.generation )
+		{
+			bool	isRegex;
+
+			{
+				juce::ScopedLock	sl ( queryLock );
+
+				query.text = pendingText;
+				query.generation = generation.load ();
+				isRegex = pendingRegex;
+			}
+
+			query.regex = nullptr;
+			query.trigrams.clear ();
+			queryValid = true;
+
+			if ( isRegex && query.text.isNotEmpty () )
+			{
+				try
+				{
+					query.regex = std::make_unique<std::regex> ( query.text.toStdString (), std::regex::ECMAScript | std::regex::icase );
+				}
+				catch ( const std::regex_error& )
+				{
+					queryValid = false;
+					query.text = {};
+				}
+			}
+			else
+			{
+				// Empty for queries shorter than a trigram, they check every message
+				getTrigrams ( query.text, query.trigrams );
+			}
+
+			runQuery ( 0 );
+		}
+		else if ( firstNew != 0 )
+		{
+			runQuery ( firstNew );
+		}
+	}
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSearch::pullNewMessages ( juce::uint64& firstNew )
+{
+	juce::Array<LogMessage>	fresh;
+
+	logging.getMessagesSince ( entries.empty () ? 0 : entries.back ().message.sequence, fresh );
+
+	for ( const auto& m : fresh )
+	{
+		// Fell behind the history, start over so sequence numbers stay contiguous
+		if ( ! entries.empty () && m.sequence != entries.back ().message.sequence + 1 )
+		{
+			entries.clear ();
+			postings.clear ();
+			numPostings = 0;
+			numLivePostings = 0;
+		}
+
+		if ( firstNew == 0 )
+			firstNew = m.sequence;
+
+		entries.push_back ( { m } );
+		index ( entries.back () );
+	}
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSearch::index ( Entry& e )
+{
+	getTrigrams ( e.message.description, scratch );
+
+	// Messages with very many trigrams get no postings and are always checked instead
+	if ( int ( scratch.size () ) > maxTrigramsPerMessage )
+		scratch.clear ();
+
+	for ( auto t : scratch )
+		postings[ t ].push_back ( e.message.sequence );
+
+	e.numTrigrams = int ( scratch.size () );
+
+	numPostings += e.numTrigrams;
+	numLivePostings += e.numTrigrams;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSearch::evictExpired ()
+{
+	const auto	oldest = logging.getOldestRetainedSequence ();
+
+	while ( ! entries.empty () && entries.front ().message.sequence < oldest )
+	{
+		numLivePostings -= entries.front ().numTrigrams;
+		entries.pop_front ();
+	}
+
+	// Postings of dropped messages are skipped by queries and removed once they make up half the index
+	if ( numPostings > 2 * numLivePostings + 65536 )
+		compact ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSearch::compact ()
+{
+	const auto	oldest = entries.empty () ? std::numeric_limits<juce::uint64>::max () : entries.front ().message.sequence;
+
+	for ( auto it = postings.begin (); it != postings.end (); )
+	{
+		auto&	list = it->second;
+
+		list.erase ( list.begin (), std::lower_bound ( list.begin (), list.end (), oldest ) );
+
+		if ( list.empty () )
+			it = postings.erase ( it );
+		else
+			++it;
+	}
+
+	numPostings = numLivePostings;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSearch::runQuery ( juce::uint64 fromSequence )
+{
+	const auto	g = query.generation;
+
+	if ( query.text.isEmpty () || entries.empty () )
+	{
+		if ( isCurrent ( g ) )
+			searching = false;
+
+		return;
+	}
+
+	const auto	firstSequence = entries.front ().message.sequence;
+	const auto	from = juce::jmax ( fromSequence, firstSequence );
+	const auto	end = firstSequence + entries.size ();
+
+	juce::Array<LogMessage>	found;
+	int						checked = 0;
+
+	auto	check = [ & ] ( juce::uint64 sequence )
+	{
+		const auto&	msg = entries[ size_t ( sequence - firstSequence ) ].message;
+
+		if ( matches ( query, msg ) )
+			found.add ( msg );
+
+		// Stream what was found so far and stop if the user typed something else
+		if ( ++checked % 1024 == 0 )
+		{
+			if ( ! isCurrent ( g ) )
+				return false;
+
+			publish ( g, found );
+		}
+
+		return true;
+	};
+
+	if ( query.trigrams.empty () )
+	{
+		for ( auto s = from; s < end; ++s )
+			if ( ! check ( s ) )
+				return;
+	}
+	else
+	{
+		std::vector<const std::vector<juce::uint64>*>	lists;
+
+		for ( auto t : query.trigrams )
+		{
+			const auto	it = postings.find ( t );
+
+			if ( it == postings.end () )
+			{
+				lists.clear ();
+				break;
+			}
+
+			lists.push_back ( &it->second );
+		}
+
+		// The rarest trigram gives the fewest candidates, the others narrow them down
+		std::sort ( lists.begin (), lists.end (), [] ( auto a, auto b ) { return a->size () < b->size (); } );
+
+		std::vector<juce::uint64>	candidates;
+
+		if ( ! lists.empty () )
+		{
+			for ( auto it = std::lower_bound ( lists[ 0 ]->begin (), lists[ 0 ]->end (), from ); it != lists[ 0 ]->end (); ++it )
+			{
+				auto	inAll = true;
+
+				for ( size_t i = 1; i < lists.size () && inAll; ++i )
+					inAll = std::binary_search ( lists[ i ]->begin (), lists[ i ]->end (), *it );
+
+				if ( inAll )
+					candidates.push_back ( *it );
+			}
+		}
+
+		// Messages without postings could match as well
+		for ( auto s = from; s < end; ++s )
+			if ( entries[ size_t ( s - firstSequence ) ].numTrigrams == 0 )
+				candidates.push_back ( s );
+
+		std::sort ( candidates.begin (), candidates.end () );
+
+		for ( auto s : candidates )
+			if ( s < end && ! check ( s ) )
+				return;
+	}
+
+	if ( isCurrent ( g ) )
+	{
+		publish ( g, found );
+		searching = false;
+	}
+}
+//-------------------------------------------------------------------------------------------------
+
+bool LogSearch::matches ( const Query& q, const LogMessage& msg ) const
+{
+	if ( q.regex )
+		return std::regex_search ( msg.description.toStdString (), *q.regex );
+
+	return msg.description.containsIgnoreCase ( q.text );
+}
+//-------------------------------------------------------------------------------------------------
+
+bool LogSearch::isCurrent ( int g )
+{
+	return generation.load () == g && ! threadShouldExit ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSearch::publish ( int g, juce::Array<LogMessage>& found )
+{
+	if ( found.isEmpty () )
+		return;
+
+	{
+		juce::ScopedLock	rl ( resultLock );
+
+		if ( resultGeneration == g )
+			results.addArray ( found );
+	}
+
+	found.clearQuick ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSearch::getTrigrams ( const juce::String& text, std::vector<juce::uint32>& dest )
+{
+	dest.clear ();
+
+	// Bytes of the lower case UTF-8 text, so a substring always shares all trigrams of its message
+	const auto	lower = text.toLowerCase ();
+	const auto	bytes = reinterpret_cast<const juce::uint8*> ( lower.toRawUTF8 () );
+	const auto	numBytes = lower.getNumBytesAsUTF8 ();
+
+	for ( size_t i = 0; i + 2 < numBytes; ++i )
+		dest.push_back ( juce::uint32 ( bytes[ i ] ) | juce::uint32 ( bytes[ i + 1 ] ) << 8 | juce::uint32 ( bytes[ i + 2 ] ) << 16 );
+
+	std::sort ( dest.begin (), dest.end () );
+	dest.erase ( std::unique ( dest.begin (), dest.end () ), dest.end () );
+}
+//-------------------------------------------------------------------------------------------------
+
+}
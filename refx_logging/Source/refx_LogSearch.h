@@ -0,0 +1,92 @@
+#pragma once
+
+#include <deque>
+#include <regex>
+#include <unordered_map>
+
+namespace reFX
+{
+//-------------------------------------------------------------------------------------------------
+// Background search over the messages the history retains, for the logging window. The thread
+// follows the log and keeps a trigram index of the message texts, so substring queries only have
+// to check messages that contain all trigrams of the query. Regular expressions and very short
+// queries check every message. Messages the history dropped are dropped from the index as well,
+// which bounds its memory by the history capacity.
+
+class LogSearch
+	: private juce::Thread
+{
+public:
+	explicit LogSearch ( Logging& );
+	~LogSearch () override;
+
+	// Starts a new search and cancels the running one. An empty text stops searching.
+	void setQuery ( const juce::String& text, bool isRegex );
+
+	// Wakes the thread to index and match newly logged messages
+	void messagesAdded ();
+
+	// Appends the matches found since the last call, in log order
+	void takeResults ( juce::Array<LogMessage>& dest );
+
+	bool isSearching () const		{ return searching; }
+	bool isQueryValid () const		{ return queryValid; }
+
+private:
+	struct Entry
+	{
+		LogMessage	message;
+		int			numTrigrams = 0;
+	};
+
+	struct Query
+	{
+		juce::String				text;
+		std::vector<juce::uint32>	trigrams;
+		std::unique_ptr<std::regex>	regex;
+		int							generation = 0;
+	};
+
+	static constexpr int	maxTrigramsPerMessage = 512;
+
+	void run () override;
+
+	void pullNewMessages ( juce::uint64& firstNew );
+	void index ( Entry& );
+	void evictExpired ();
+	void compact ();
+
+	void runQuery ( juce::uint64 fromSequence );
+	bool matches ( const Query&, const LogMessage& ) const;
+	bool isCurrent ( int generation );
+	void publish ( int generation, juce::Array<LogMessage>& found );
+
+	static void getTrigrams ( const juce::String&, std::vector<juce::uint32>& );
+
+	Logging&		logging;
+
+	// Owned by the thread
+	std::deque<Entry>											entries;		// Contiguous sequence numbers
+	std::unordered_map<juce::uint32, std::vector<juce::uint64>>	postings;		// Trigram -> sequences
+	juce::int64													numPostings = 0;
+	juce::int64													numLivePostings = 0;
+	std::vector<juce::uint32>									scratch;
+	Query														query;
+
+	juce::CriticalSection		queryLock;
+	juce::String				pendingText;
+	bool						pendingRegex = false;
+	std::atomic<int>			generation { 0 };
+
+	juce::CriticalSection		resultLock;
+	juce::Array<LogMessage>		results;
+	int							resultGeneration = 0;
+
+	juce::WaitableEvent			wakeUp;
+	std::atomic<bool>			searching { false };
+	std::atomic<bool>			queryValid { true };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR ( LogSearch )
+};
+//-------------------------------------------------------------------------------------------------
+}
@@ -0,0 +1,211 @@
+#include "refx_LogSink.h"
+
+//-------------------------------------------------------------------------------------------------
+
+namespace reFX
+{
+
+LogSink::LogSink ( const LogSinkOptions& o )
+{
+	setOptions ( o );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSink::setOptions ( const LogSinkOptions& o )
+{
+	minLevel = int ( o.minLevel );
+	asynchronous = o.asynchronous;
+	batchSize = juce::jmax ( 1, o.batchSize );
+}
+//-------------------------------------------------------------------------------------------------
+
+LogSinkOptions LogSink::getOptions ()
+{
+	LogSinkOptions	o;
+	o.minLevel = LogLevel ( minLevel.load () );
+	o.asynchronous = asynchronous;
+	o.batchSize = batchSize;
+
+	return o;
+}
+//-------------------------------------------------------------------------------------------------
+
+bool LogSink::deliver ( const LogMessage* messages, size_t numMessages )
+{
+	const auto	level = minLevel.load ();
+
+	if ( asynchronous )
+	{
+		juce::ScopedLock	sl ( pendingLock );
+
+		for ( size_t i = 0; i < numMessages; ++i )
+			if ( int ( messages[ i ].level ) >= level )
+				pending.push_back ( messages[ i ] );
+
+		return ! pending.empty ();
+	}
+
+	juce::ScopedLock	sl ( writeLock );
+
+	// Left over from asynchronous mode, they were logged first
+	writePending ();
+
+	// Runs of accepted messages are passed on as they are, without copying them
+	for ( size_t i = 0; i < numMessages; )
+	{
+		while ( i < numMessages && int ( messages[ i ].level ) < level )
+			++i;
+
+		auto	end = i;
+
+		while ( end < numMessages && int ( messages[ end ].level ) >= level )
+			++end;
+
+		writeAccepted ( messages + i, end - i );
+
+		i = end;
+	}
+
+	return false;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSink::writePending ()
+{
+	juce::ScopedLock	sl ( writeLock );
+
+	{
+		juce::ScopedLock	pl ( pendingLock );
+
+		if ( pending.empty () )
+			return;
+
+		std::swap ( pending, batch );
+	}
+
+	writeAccepted ( batch.data (), batch.size () );
+
+	batch.clear ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSink::writeAccepted ( const LogMessage* messages, size_t numMessages )
+{
+	const auto	chunk = size_t ( batchSize.load () );
+
+	for ( size_t i = 0; i < numMessages; i += chunk )
+		write ( messages + i, int ( juce::jmin ( chunk, numMessages - i ) ) );
+}
+//-------------------------------------------------------------------------------------------------
+
+LogSinkDispatcher::LogSinkDispatcher ()
+	: juce::Thread ( "reFX log sinks" )
+{
+}
+//-------------------------------------------------------------------------------------------------
+
+LogSinkDispatcher::~LogSinkDispatcher ()
+{
+	signalThreadShouldExit ();
+	wakeUp.signal ();
+	stopThread ( 10000 );
+
+	writeAllPending ( true );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSinkDispatcher::add ( std::shared_ptr<LogSink> sink )
+{
+	jassert ( sink != nullptr );
+
+	juce::ScopedLock	sl ( lock );
+
+	sinks.push_back ( std::move ( sink ) );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSinkDispatcher::remove ( const std::shared_ptr<LogSink>& sink )
+{
+	if ( sink == nullptr )
+		return;
+
+	{
+		juce::ScopedLock	sl ( lock );
+
+		const auto	it = std::find ( sinks.begin (), sinks.end (), sink );
+
+		if ( it == sinks.end () )
+			return;
+
+		sinks.erase ( it );
+	}
+
+	juce::ScopedLock	wl ( sink->writeLock );
+
+	sink->writePending ();
+	sink->flush ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSinkDispatcher::deliver ( const LogMessage* messages, size_t numMessages )
+{
+	auto	leftPending = false;
+
+	{
+		juce::ScopedLock	sl ( lock );
+
+		for ( const auto& sink : sinks )
+			leftPending = sink->deliver ( messages, numMessages ) || leftPending;
+	}
+
+	if ( leftPending )
+	{
+		if ( ! isThreadRunning () && ! threadShouldExit () )
+			startThread ( juce::Thread::Priority::low );
+
+		wakeUp.signal ();
+	}
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSinkDispatcher::flush ()
+{
+	writeAllPending ( true );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSinkDispatcher::run ()
+{
+	while ( ! threadShouldExit () )
+	{
+		wakeUp.wait ( -1.0 );
+
+		writeAllPending ( false );
+	}
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSinkDispatcher::writeAllPending ( bool flushSinks )
+{
+	// Slow sinks are written without holding up delivery to the others
+	std::vector<std::shared_ptr<LogSink>>	current;
+
+	{
+		juce::ScopedLock	sl ( lock );
+
+		current = sinks;
+	}
+
+	for ( const auto& sink : current )
+	{
+		juce::ScopedLock	wl ( sink->writeLock );
+
+		sink->writePending ();
+
+		if ( flushSinks )
+			sink->flush ();
+	}
+}
+//-------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+namespace reFX
+{
+//-------------------------------------------------------------------------------------------------
+
+struct LogSinkOptions
+{
+	LogLevel	minLevel = LogLevel::debuglog;		// Messages below this level are not passed on
+	bool		asynchronous = false;				// Write on the sink thread instead of the logging thread
+	int			batchSize = 256;					// Most messages passed to a single write call
+};
+//-------------------------------------------------------------------------------------------------
+// Output for delivered messages, see Logging::addSink. A sink gets every message at or above its
+// level in delivery order. Synchronous sinks are written by whichever thread delivers, asynchronous
+// ones by a shared sink thread, so a slow sink does not hold up the others.
+
+class LogSink
+{
+public:
+	LogSink ( const LogSinkOptions& = {} );
+	virtual ~LogSink () = default;
+
+	void setOptions ( const LogSinkOptions& );
+	LogSinkOptions getOptions ();
+
+protected:
+	// Never called concurrently, messages are in delivery order
+	virtual void write ( const LogMessage* messages, int numMessages ) = 0;
+	virtual void flush ()	{}
+
+private:
+	friend class LogSinkDispatcher;
+
+	// Returns true if messages were left for the sink thread
+	bool deliver ( const LogMessage* messages, size_t numMessages );
+	void writePending ();
+	void writeAccepted ( const LogMessage* messages, size_t numMessages );
+
+	std::atomic<int>			minLevel { 0 };
+	std::atomic<bool>			asynchronous { false };
+	std::atomic<int>			batchSize { 256 };
+
+	juce::CriticalSection		writeLock;
+	juce::CriticalSection		pendingLock;
+	std::vector<LogMessage>		pending;
+	std::vector<LogMessage>		batch;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR ( LogSink )
+};
+//-------------------------------------------------------------------------------------------------
+// The registered sinks and the thread that writes the asynchronous ones
+
+class LogSinkDispatcher
+	: private juce::Thread
+{
+public:
+	LogSinkDispatcher ();
+	~LogSinkDispatcher () override;
+
+	void add ( std::shared_ptr<LogSink> );
+
+	// Messages that are still pending for the sink are written before this returns
+	void remove ( const std::shared_ptr<LogSink>& );
+
+	void deliver ( const LogMessage* messages, size_t numMessages );
+
+	// Writes everything pending and flushes all sinks
+	void flush ();
+
+private:
+	void run () override;
+	void writeAllPending ( bool flushSinks );
+
+	juce::CriticalSection					lock;
+	std::vector<std::shared_ptr<LogSink>>	sinks;
+	juce::WaitableEvent						wakeUp;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR ( LogSinkDispatcher )
+};
+//-------------------------------------------------------------------------------------------------
+}
@@ -0,0 +1,107 @@
+#include <cstdio>
+
+#include "refx_LogSinks.h"
+
+//-------------------------------------------------------------------------------------------------
+
+namespace reFX
+{
+
+FileLogSink::FileLogSink ( const LogSinkOptions& o )
+	: LogSink ( o )
+{
+}
+//-------------------------------------------------------------------------------------------------
+
+void FileLogSink::write ( const LogMessage* messages, int numMessages )
+{
+	writer.write ( messages, numMessages );
+}
+//-------------------------------------------------------------------------------------------------
+
+void FileLogSink::flush ()
+{
+	writer.flush ();
+}
+//-------------------------------------------------------------------------------------------------
+
+StderrLogSink::StderrLogSink ( const LogSinkOptions& o )
+	: LogSink ( o )
+{
+}
+//-------------------------------------------------------------------------------------------------
+
+void StderrLogSink::write ( const LogMessage* messages, int numMessages )
+{
+	buffer.reset ();
+
+	for ( int i = 0; i < numMessages; ++i )
+	{
+		messages[ i ].writeTo ( buffer );
+		buffer.write ( "\n", 1 );
+	}
+
+	std::fwrite ( buffer.getData (), 1, buffer.getDataSize (), stderr );
+	std::fflush ( stderr );
+}
+//-------------------------------------------------------------------------------------------------
+
+DebugOutputLogSink::DebugOutputLogSink ( const LogSinkOptions& o )
+	: LogSink ( o )
+{
+}
+//-------------------------------------------------------------------------------------------------
+
+void DebugOutputLogSink::write ( const LogMessage* messages, int numMessages )
+{
+	for ( int i = 0; i < numMessages; ++i )
+		juce::Logger::outputDebugString ( messages[ i ].toString () );
+}
+//-------------------------------------------------------------------------------------------------
+
+MemoryLogSink::MemoryLogSink ( int capacity, const LogSinkOptions& o )
+	: LogSink ( o )
+	, history ( capacity )
+{
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::Array<LogMessage> MemoryLogSink::getMessages ()
+{
+	juce::ScopedLock	sl ( lock );
+
+	return history.getMessages ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void MemoryLogSink::clear ()
+{
+	juce::ScopedLock	sl ( lock );
+
+	history.clear ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void MemoryLogSink::write ( const LogMessage* messages, int numMessages )
+{
+	juce::ScopedLock	sl ( lock );
+
+	for ( int i = 0; i < numMessages; ++i )
+		history.add ( messages[ i ] );
+}
+//-------------------------------------------------------------------------------------------------
+
+ListenerLogSink::ListenerLogSink ( Logging& l, const LogSinkOptions& o )
+	: LogSink ( o )
+	, owner ( l )
+{
+}
+//-------------------------------------------------------------------------------------------------
+
+void ListenerLogSink::write ( const LogMessage* messages, int numMessages )
+{
+	owner.queueForListeners ( messages, numMessages );
+}
+//-------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+namespace reFX
+{
+//-------------------------------------------------------------------------------------------------
+// Built-in sinks, see Logging::addSink
+
+// Rotating log files, configured through the writer or Logging::setLogFolder/setWriterOptions
+class FileLogSink
+	: public LogSink
+{
+public:
+	FileLogSink ( const LogSinkOptions& = {} );
+
+	LogWriter& getWriter ()		{ return writer; }
+
+protected:
+	void write ( const LogMessage* messages, int numMessages ) override;
+	void flush () override;
+
+private:
+	LogWriter	writer;
+};
+//-------------------------------------------------------------------------------------------------
+
+// Standard error, e.g. for command line tools
+class StderrLogSink
+	: public LogSink
+{
+public:
+	StderrLogSink ( const LogSinkOptions& = {} );
+
+protected:
+	void write ( const LogMessage* messages, int numMessages ) override;
+
+private:
+	juce::MemoryOutputStream	buffer;
+};
+//-------------------------------------------------------------------------------------------------
+
+// Debugger output. Costs a kernel transition per message on Windows, so it is only registered by
+// default when REFX_LOG_DEBUG_OUTPUT is enabled.
+class DebugOutputLogSink
+	: public LogSink
+{
+public:
+	DebugOutputLogSink ( const LogSinkOptions& = {} );
+
+protected:
+	void write ( const LogMessage* messages, int numMessages ) override;
+};
+//-------------------------------------------------------------------------------------------------
+
+// Keeps the most recent messages in memory
+class MemoryLogSink
+	: public LogSink
+{
+public:
+	MemoryLogSink ( int capacity, const LogSinkOptions& = {} );
+
+	juce::Array<LogMessage> getMessages ();
+	void clear ();
+
+protected:
+	void write ( const LogMessage* messages, int numMessages ) override;
+
+private:
+	juce::CriticalSection	lock;
+	LogHistory				history;
+};
+//-------------------------------------------------------------------------------------------------
+
+// Passes messages to the Logging::Listener objects on the message thread
+class ListenerLogSink
+	: public LogSink
+{
+public:
+	ListenerLogSink ( Logging&, const LogSinkOptions& = {} );
+
+protected:
+	void write ( const LogMessage* messages, int numMessages ) override;
+
+private:
+	Logging&	owner;
+};
+//-------------------------------------------------------------------------------------------------
+}
@@ -0,0 +1,128 @@
+#include "refx_LogStats.h"
+
+//-------------------------------------------------------------------------------------------------
+
+namespace reFX
+{
+
+void LogLatencyHistogram::add ( juce::int64 ns ) noexcept
+{
+	// Durations come from the monotonic clock, this only guards the totals against a broken caller
+	ns = juce::jmax ( juce::int64 ( 0 ), ns );
+
+	// Bucket i holds durations below 2^i nanoseconds
+	auto	bucket = 0;
+
+	for ( auto v = juce::uint64 ( ns ); v != 0 && bucket < numBuckets - 1; v >>= 1 )
+		++bucket;
+
+	buckets[ size_t ( bucket ) ].fetch_add ( 1, std::memory_order_relaxed );
+	count.fetch_add ( 1, std::memory_order_relaxed );
+	totalNs.fetch_add ( ns, std::memory_order_relaxed );
+
+	for ( auto m = maxNs.load ( std::memory_order_relaxed ); ns > m && ! maxNs.compare_exchange_weak ( m, ns, std::memory_order_relaxed ); )
+		;
+}
+//-------------------------------------------------------------------------------------------------
+
+LogLatencyHistogram::Snapshot LogLatencyHistogram::getSnapshot () const
+{
+	// Not one consistent moment, but close enough for a diagnostics display
+	Snapshot	s;
+
+	s.count = count.load ( std::memory_order_relaxed );
+	s.totalNs = totalNs.load ( std::memory_order_relaxed );
+	s.maxNs = maxNs.load ( std::memory_order_relaxed );
+
+	for ( size_t i = 0; i < buckets.size (); ++i )
+		s.buckets[ i ] = buckets[ i ].load ( std::memory_order_relaxed );
+
+	return s;
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::int64 LogLatencyHistogram::Snapshot::getPercentileNs ( double fraction ) const
+{
+	juce::int64	total = 0;
+
+	for ( auto n : buckets )
+		total += n;
+
+	const auto	target = juce::int64 ( std::ceil ( fraction * double ( total ) ) );
+	juce::int64	seen = 0;
+
+	for ( size_t i = 0; i < buckets.size (); ++i )
+	{
+		seen += buckets[ i ];
+
+		if ( seen >= target && seen > 0 )
+			return juce::jmin ( juce::int64 ( 1 ) << i, maxNs );
+	}
+
+	return maxNs;
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String LogLatencyHistogram::Snapshot::toString () const
+{
+	if ( count == 0 )
+		return "none";
+
+	return juce::String ( count ) + ", p50 " + formatDuration ( getPercentileNs ( 0.5 ) ) + ", p99 " + formatDuration ( getPercentileNs ( 0.99 ) )
+		 + ", max " + formatDuration ( maxNs ) + ", total " + formatDuration ( totalNs );
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String LogLatencyHistogram::formatDuration ( juce::int64 ns )
+{
+	if ( ns < 1000 )
+		return juce::String ( ns ) + " ns";
+
+	if ( ns < 1000000 )
+		return juce::String ( double ( ns ) / 1e3, 1 ) + " us";
+
+	if ( ns < 1000000000 )
+		return juce::String ( double ( ns ) / 1e6, 1 ) + " ms";
+
+	return juce::String ( double ( ns ) / 1e9, 2 ) + " s";
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::int64 LogStats::getNumMessages () const
+{
+	juce::int64	total = 0;
+
+	for ( auto n : messages )
+		total += n;
+
+	return total;
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String LogStats::toString () const
+{
+	juce::String	text;
+
+	text += "Logging:   " + juce::String ( getNumMessages () ) + " messages ("
+		  + juce::String ( messages[ size_t ( LogLevel::error ) ] ) + " errors, "
+		  + juce::String ( messages[ size_t ( LogLevel::warning ) ] ) + " warnings, "
+		  + juce::String ( messages[ size_t ( LogLevel::info ) ] ) + " info, "
+		  + juce::String ( messages[ size_t ( LogLevel::log ) ] ) + " log, "
+		  + juce::String ( messages[ size_t ( LogLevel::debuglog ) ] ) + " debug)\r\n";
+
+	text += "Lost:      " + juce::String ( dropped ) + " dropped, " + juce::String ( droppedRealtime ) + " real-time dropped, "
+		  + juce::String ( filtered ) + " filtered, " + juce::String ( rateLimited ) + " rate limited, "
+		  + juce::String ( repeatsCollapsed ) + " repeats collapsed\r\n";
+
+	text += "Queue:     " + juce::String ( queueHighWater ) + " of " + juce::String ( queueCapacity ) + " slots used at most\r\n";
+	text += "Log file:  " + juce::File::descriptionOfSizeInBytes ( bytesWritten ) + " written\r\n";
+	text += "Writes:    " + writeLatency.toString () + "\r\n";
+	text += "Flushes:   " + flushLatency.toString () + "\r\n";
+	text += "Delivery:  " + deliveryTime.toString () + "\r\n";
+	text += "Blocked:   " + blockedTime.toString () + "\r\n";
+
+	return text;
+}
+//-------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+
+namespace reFX
+{
+//-------------------------------------------------------------------------------------------------
+// Durations in power-of-two buckets of nanoseconds. Recording is a few relaxed atomic adds, so it
+// can stay on in release builds. Percentiles are the upper bound of their bucket.
+
+class LogLatencyHistogram
+{
+public:
+	static constexpr int	numBuckets = 40;		// Up to about 9 minutes, longer ones land in the last
+
+	void add ( juce::int64 ns ) noexcept;
+
+	struct Snapshot
+	{
+		juce::int64								count = 0;
+		juce::int64								totalNs = 0;
+		juce::int64								maxNs = 0;
+		std::array<juce::int64, numBuckets>		buckets {};
+
+		juce::int64 getPercentileNs ( double fraction ) const;
+		juce::int64 getMeanNs () const				{ return count > 0 ? totalNs / count : 0; }
+
+		// "n, p50 1.2 us, p99 35 us, max 2.1 ms"
+		juce::String toString () const;
+	};
+
+	Snapshot getSnapshot () const;
+
+	static juce::String formatDuration ( juce::int64 ns );
+
+private:
+	std::atomic<juce::int64>								count { 0 };
+	std::atomic<juce::int64>								totalNs { 0 };
+	std::atomic<juce::int64>								maxNs { 0 };
+	std::array<std::atomic<juce::int64>, numBuckets>		buckets {};
+};
+//-------------------------------------------------------------------------------------------------
+// What the logging pipeline did since startup, see Logging::getStats
+
+struct LogStats
+{
+	std::array<juce::int64, 5>		messages {};				// Logged, indexed by LogLevel, collapsed repeats included
+	juce::int64						repeatsCollapsed = 0;		// Folded into "Last message repeated N times"
+	juce::int64						filtered = 0;				// Below the level in Logging, the macros check the global level before any counting
+	juce::int64						rateLimited = 0;			// Suppressed by the Z_*_EVERY macros
+	juce::int64						dropped = 0;				// Queue full, see LogOverflowPolicy
+	juce::int64						droppedRealtime = 0;
+	int								queueHighWater = 0;
+	int								queueCapacity = 0;
+
+	juce::int64						bytesWritten = 0;			// To log files, headers not included
+	LogLatencyHistogram::Snapshot	writeLatency;				// Writing one batch of messages to the log file
+	LogLatencyHistogram::Snapshot	flushLatency;				// Flushing the log file
+
+	LogLatencyHistogram::Snapshot	deliveryTime;				// A producer delivering queued messages to the sinks for everybody
+	LogLatencyHistogram::Snapshot	blockedTime;				// A producer waiting for room with LogOverflowPolicy::block
+
+	juce::int64 getNumMessages () const;
+
+	// A few lines in the layout of Logging::getSystemStats
+	juce::String toString () const;
+};
+//-------------------------------------------------------------------------------------------------
+}
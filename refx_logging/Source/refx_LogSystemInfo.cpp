@@ -0,0 +1,119 @@
+#include "refx_LogSystemInfo.h"
+
+//-------------------------------------------------------------------------------------------------
+
+namespace reFX
+{
+
+LogSystemInfo::LogSystemInfo ()
+	: juce::Thread ( "reFX system info" )
+{
+	startThread ( juce::Thread::Priority::low );
+}
+//-------------------------------------------------------------------------------------------------
+
+LogSystemInfo::~LogSystemInfo ()
+{
+	stopThread ( 10000 );
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String LogSystemInfo::getMachineInfo ( int timeoutMs )
+{
+	if ( ! gathered.wait ( double ( timeoutMs ) ) )
+		return {};
+
+	return machineInfo;
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String LogSystemInfo::getDisplayInfo ()
+{
+	juce::ScopedLock	sl ( displayLock );
+
+	return displayInfo;
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String LogSystemInfo::getSummary ()
+{
+	return getMachineInfo () + getDisplayInfo ();
+}
+//-------------------------------------------------------------------------------------------------
+
+bool LogSystemInfo::updateDisplays ()
+{
+	jassert ( juce::MessageManager::existsAndIsCurrentThread () );
+
+	juce::String	text;
+
+	for ( const auto& d : juce::Desktop::getInstance().getDisplays ().displays )
+	{
+		const auto	physRect = ( d.totalArea.toDouble () * d.scale ).toNearestIntEdges ();
+
+		text += juce::String::formatted ( "Display:   %d x %d @ %d%%\r\n", physRect.getWidth (), physRect.getHeight (), juce::roundToInt ( d.scale * 100.0 ) );
+	}
+
+	juce::ScopedLock	sl ( displayLock );
+
+	if ( text == displayInfo )
+		return false;
+
+	displayInfo = text;
+	return true;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogSystemInfo::run ()
+{
+	juce::String	text;
+
+	text += "Location:  " + juce::File::getSpecialLocation ( juce::File::currentApplicationFile ).getFullPathName () + "\r\n\r\n";
+
+	//
+	// Computer specific
+	//
+	text += "Computer:  " + juce::SystemStats::getComputerName () + "\r\n";
+	text += "OS:        " + juce::SystemStats::getOperatingSystemName () + "\r\n";
+	text += "Device:    " + ( juce::SystemStats::getDeviceManufacturer () + " " + juce::SystemStats::getDeviceDescription () ).trim () + "\r\n";
+	text += "Admin:     " + juce::String ( isCurrentUserAdmin () ? "Yes" : "No" ) + "\r\n\r\n";
+
+	//
+	// CPU specific
+	//
+	text += "CPU:       " + juce::SystemStats::getCpuVendor () + " " + juce::SystemStats::getCpuModel () + " " + juce::String ( juce::SystemStats::getCpuSpeedInMegahertz () ) + " MHz\r\n";
+	text += "Cores:     " + juce::String ( juce::SystemStats::getNumPhysicalCpus () ) + " / " + juce::String ( juce::SystemStats::getNumCpus () ) + "\r\n";
+	text += "Memory:    " + juce::String ( juce::roundToInt ( juce::SystemStats::getMemorySizeInMegabytes () / 1024.0 ) ) + " GB" + "\r\n";
+
+	machineInfo = text;
+	gathered.signal ();
+}
+//-------------------------------------------------------------------------------------------------
+
+bool LogSystemInfo::isCurrentUserAdmin ()
+{
+#if JUCE_MAC || JUCE_LINUX
+	return geteuid () == 0;
+#elif JUCE_WINDOWS
+	// Get authority information
+	SID_IDENTIFIER_AUTHORITY	NtAuthority = SECURITY_NT_AUTHORITY;
+	PSID						AdministratorsGroup;
+
+	if ( AllocateAndInitializeSid ( &NtAuthority, 2, SECURITY_BUILTIN_DOMAIN_RID, DOMAIN_ALIAS_RID_ADMINS, 0, 0, 0, 0, 0, 0, &AdministratorsGroup ) )
+	{
+		BOOL	isMember = false;
+
+		CheckTokenMembership ( nullptr, AdministratorsGroup, &isMember );
+
+		FreeSid ( AdministratorsGroup );
+
+		return isMember;
+	}
+	return false;
+#else
+	#error "Unknown platform!"
+#endif
+}
+//-------------------------------------------------------------------------------------------------
+
+}
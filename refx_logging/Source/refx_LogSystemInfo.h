@@ -0,0 +1,45 @@
+#pragma once
+
+namespace reFX
+{
+//-------------------------------------------------------------------------------------------------
+// The machine details of the support report. Some of them take a while to query, so they are
+// gathered once on a background thread and cached. The displays can only be read on the message
+// thread and change at runtime, the logging timer keeps them up to date. Everything can be read
+// from any thread, e.g. by a sink that starts each of its files with the summary.
+
+class LogSystemInfo
+	: private juce::Thread
+{
+public:
+	LogSystemInfo ();
+	~LogSystemInfo () override;
+
+	// Application, computer, CPU and memory. Waits up to timeoutMs if the background thread is
+	// still busy, -1 for as long as it takes. Empty if it is not done in time.
+	juce::String getMachineInfo ( int timeoutMs = -1 );
+
+	// One line per display, empty until the message thread read them
+	juce::String getDisplayInfo ();
+
+	// Machine and display info
+	juce::String getSummary ();
+
+	// Message thread only. Reads the displays again and returns true if they changed.
+	bool updateDisplays ();
+
+private:
+	void run () override;
+
+	static bool isCurrentUserAdmin ();
+
+	juce::WaitableEvent		gathered { true };
+	juce::String			machineInfo;			// Written once before gathered is signalled
+
+	juce::CriticalSection	displayLock;
+	juce::String			displayInfo;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR ( LogSystemInfo )
+};
+//-------------------------------------------------------------------------------------------------
+}
@@ -0,0 +1,421 @@
+#include "refx_LogTrace.h"
+
+//-------------------------------------------------------------------------------------------------
+
+namespace reFX
+{
+
+// Events of one thread. Only that thread writes and only the trace writer reads, so a single
+// producer ring needs no atomic read-modify-write. Full buffers drop events.
+class LogTrace::ThreadBuffer
+{
+public:
+	// Pool buffers have no name yet, the writer shows the id of the thread that takes them
+	explicit ThreadBuffer ( const juce::String& name )
+		: events ( new Event[ REFX_TRACE_BUFFER_SIZE ] )
+		, mask ( REFX_TRACE_BUFFER_SIZE - 1 )
+		, threadName ( name )
+	{
+		static_assert ( ( REFX_TRACE_BUFFER_SIZE & ( REFX_TRACE_BUFFER_SIZE - 1 ) ) == 0, "REFX_TRACE_BUFFER_SIZE must be a power of two" );
+	}
+
+	bool push ( const Event& e ) noexcept
+	{
+		const auto	h = head.load ( std::memory_order_relaxed );
+
+		if ( h - tail.load ( std::memory_order_acquire ) > mask )
+			return false;
+
+		events[ h & mask ] = e;
+		head.store ( h + 1, std::memory_order_release );
+		return true;
+	}
+
+	template <typename Callback>
+	void drain ( Callback&& callback )
+	{
+		auto		t = tail.load ( std::memory_order_relaxed );
+		const auto	h = head.load ( std::memory_order_acquire );
+
+		for ( ; t != h; ++t )
+			callback ( events[ t & mask ] );
+
+		tail.store ( t, std::memory_order_release );
+	}
+
+	// Empty while a pool buffer has no thread
+	juce::String getThreadName () const
+	{
+		if ( threadName.isNotEmpty () )
+			return threadName;
+
+		const auto	id = threadId.load ( std::memory_order_acquire );
+
+		return id != 0 ? juce::String::toHexString ( juce::int64 ( id ) ) : juce::String ();
+	}
+
+	int							index = 0;				// Thread id in the trace, assigned by the writer
+	std::atomic<bool>			threadExited { false };
+	std::atomic<bool>			claimed { false };		// Pool buffers only, taken by a thread for the current trace
+	std::atomic<juce::uint64>	threadId { 0 };			// Pool buffers only, set after claimed
+
+private:
+	std::unique_ptr<Event[]>	events;
+	const size_t				mask;
+	std::atomic<size_t>			head { 0 };
+	std::atomic<size_t>			tail { 0 };
+	juce::String				threadName;
+};
+//-------------------------------------------------------------------------------------------------
+// Appends the buffered events to the trace file a few times per second
+
+class LogTrace::Writer
+	: public juce::Thread
+{
+public:
+	explicit Writer ( const juce::File& f )
+		: juce::Thread ( "reFX trace writer" )
+		, stream ( f )
+	{
+	}
+
+	bool open ()
+	{
+		if ( ! stream.openedOk () || ! stream.truncate ().wasOk () )
+			return false;
+
+		// The array format, viewers accept it without the closing bracket after a crash
+		stream << "[\n";
+		writeMetadata ( "process_name", 0, juce::File::getSpecialLocation ( juce::File::currentExecutableFile ).getFileNameWithoutExtension () );
+		return true;
+	}
+
+	void run () override
+	{
+		while ( ! threadShouldExit () )
+		{
+			wait ( 250 );
+			writePending ();
+		}
+	}
+
+	void finish ()
+	{
+		writePending ();
+
+		stream << "{}]\n";
+		stream.flush ();
+	}
+
+	juce::File getFile () const		{ return stream.getFile (); }
+
+	// Buffers of finished threads go once they are written
+	static void removeExitedThreads ()
+	{
+		juce::ScopedLock	sl ( buffersLock );
+
+		buffers.erase ( std::remove_if ( buffers.begin (), buffers.end (), [] ( const auto& b ) { return b->threadExited.load (); } ), buffers.end () );
+	}
+
+	static inline juce::CriticalSection								buffersLock;
+	static inline std::vector<std::shared_ptr<ThreadBuffer>>		buffers;
+
+private:
+	void writePending ()
+	{
+		std::vector<std::shared_ptr<ThreadBuffer>>	current;
+
+		{
+			juce::ScopedLock	sl ( buffersLock );
+			current = buffers;
+		}
+
+		for ( auto& b : current )
+		{
+			if ( b->index == 0 )
+			{
+				const auto	name = b->getThreadName ();
+
+				// A pool buffer nobody took yet
+				if ( name.isEmpty () )
+					continue;
+
+				b->index = ++numThreads;
+				writeMetadata ( "thread_name", b->index, name );
+			}
+
+			b->drain ( [ this, &b ] ( const Event& e ) { writeEvent ( *b, e ); } );
+		}
+
+		stream.flush ();
+
+		removeExitedThreads ();
+	}
+
+	void writeEvent ( const ThreadBuffer& b, const Event& e )
+	{
+		// Microseconds since the start of the trace, doubles would lose the nanoseconds of absolute times
+		char	text[ 256 ];
+		auto	n = std::snprintf ( text, sizeof ( text ), "{\"ph\":\"%c\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,", e.phase, b.index, double ( e.timeNs - startNs ) / 1000.0 );
+
+		if ( e.phase == 'X' )
+			n += std::snprintf ( text + n, sizeof ( text ) - size_t ( n ), "\"dur\":%.3f,", double ( e.durationNs ) / 1000.0 );
+		else if ( e.phase == 'C' )
+			n += std::snprintf ( text + n, sizeof ( text ) - size_t ( n ), "\"args\":{\"value\":%.9g},", e.value );
+		else
+			n += std::snprintf ( text + n, sizeof ( text ) - size_t ( n ), "\"s\":\"t\"," );
+
+		stream.write ( text, size_t ( n ) );
+		stream << "\"name\":";
+		writeJsonString ( e.name );
+		stream << "},\n";
+	}
+
+	void writeMetadata ( const char* kind, int tid, const juce::String& value )
+	{
+		stream << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"name\":\"" << kind << "\",\"args\":{\"name\":";
+		writeJsonString ( value.toRawUTF8 () );
+		stream << "}},\n";
+	}
+
+	void writeJsonString ( const char* s )
+	{
+		stream.writeByte ( '"' );
+
+		for ( ; *s != 0; ++s )
+		{
+			if ( *s == '"' || *s == '\\' )
+				stream.writeByte ( '\\' );
+
+			if ( juce::uint8 ( *s ) >= 0x20 )
+				stream.writeByte ( *s );
+		}
+
+		stream.writeByte ( '"' );
+	}
+
+	juce::FileOutputStream	stream;
+	juce::int64				startNs = LogClock::now ();
+	int						numThreads = 0;
+};
+//-------------------------------------------------------------------------------------------------
+
+static juce::CriticalSection						traceLock;
+static std::unique_ptr<juce::Thread>				traceWriterThread;
+
+bool LogTrace::start ( const juce::File& folder )
+{
+	stop ();
+
+	if ( ! folder.createDirectory () )
+		return false;
+
+	// Only the newest traces are kept
+	constexpr int	maxTraceFiles = 8;
+
+	auto	old = folder.findChildFiles ( juce::File::findFiles, false, "*.trace.json" );
+	std::sort ( old.begin (), old.end (), [] ( const auto& a, const auto& b ) { return a.getLastModificationTime () > b.getLastModificationTime (); } );
+
+	for ( int i = maxTraceFiles - 1; i < old.size (); ++i )
+		old.getReference ( i ).deleteFile ();
+
+	const auto	file = folder.getChildFile ( juce::Time::getCurrentTime ().toISO8601 ( false ) + ".trace.json" ).getNonexistentSibling ();
+	auto		writer = std::make_unique<Writer> ( file );
+
+	if ( ! writer->open () )
+		return false;
+
+	{
+		juce::ScopedLock	sl ( Writer::buffersLock );
+
+		// Allocated once, recording threads keep pointers to them
+		if ( pool[ 0 ].load () == nullptr )
+		{
+			for ( auto& slot : pool )
+			{
+				auto	b = std::make_shared<ThreadBuffer> ( juce::String () );
+				Writer::buffers.push_back ( b );
+				slot.store ( b.get (), std::memory_order_release );
+			}
+		}
+
+		// Threads take pool buffers again in the new trace, a thread that still holds one from an
+		// earlier trace sees the new generation and gives it up
+		poolGeneration.fetch_add ( 1, std::memory_order_acq_rel );
+
+		for ( auto& slot : pool )
+		{
+			const auto	b = slot.load ( std::memory_order_relaxed );
+
+			b->threadId.store ( 0, std::memory_order_relaxed );
+			b->claimed.store ( false, std::memory_order_release );
+		}
+
+		// Whatever was recorded after the last trace stopped does not belong into this one, and the
+		// new trace numbers its threads from the start
+		for ( auto& b : Writer::buffers )
+		{
+			b->drain ( [] ( const Event& ) {} );
+			b->index = 0;
+		}
+	}
+
+	Writer::removeExitedThreads ();
+
+	juce::ScopedLock	sl ( traceLock );
+
+	writer->startThread ( juce::Thread::Priority::low );
+	traceWriterThread = std::move ( writer );
+	enabled = true;
+
+	return true;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogTrace::stop ()
+{
+	std::unique_ptr<juce::Thread>	writer;
+
+	{
+		juce::ScopedLock	sl ( traceLock );
+
+		enabled = false;
+		writer = std::move ( traceWriterThread );
+	}
+
+	if ( writer == nullptr )
+		return;
+
+	writer->signalThreadShouldExit ();
+	writer->notify ();
+	writer->stopThread ( 10000 );
+
+	static_cast<Writer&> ( *writer ).finish ();
+
+	// Threads that ended after the last write, no writer runs until the next trace
+	Writer::removeExitedThreads ();
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::File LogTrace::getFile ()
+{
+	juce::ScopedLock	sl ( traceLock );
+
+	return traceWriterThread != nullptr ? static_cast<Writer&> ( *traceWriterThread ).getFile () : juce::File ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogTrace::registerThread ()
+{
+	if ( threadBuffer != nullptr )
+		return;
+
+	// The writer keeps the buffer until it wrote the rest of its events
+	struct Holder
+	{
+		~Holder ()
+		{
+			if ( buffer == nullptr )
+				return;
+
+			// Events from later thread_local destructors go to the pool instead
+			threadBuffer = nullptr;
+			buffer->threadExited = true;
+		}
+
+		std::shared_ptr<ThreadBuffer>	buffer;
+	};
+
+	thread_local Holder	holder;
+
+	holder.buffer = std::make_shared<ThreadBuffer> ( LogMessage::getCurrentThreadName () );
+
+	{
+		juce::ScopedLock	sl ( Writer::buffersLock );
+		Writer::buffers.push_back ( holder.buffer );
+	}
+
+	threadBuffer = holder.buffer.get ();
+}
+//-------------------------------------------------------------------------------------------------
+
+LogTrace::ThreadBuffer* LogTrace::getThreadBuffer () noexcept
+{
+	if ( threadBuffer != nullptr )
+		return threadBuffer;
+
+	const auto	generation = poolGeneration.load ( std::memory_order_acquire );
+
+	if ( pooledGeneration == generation )
+		return pooledBuffer;
+
+	// Only atomics, real-time threads get here on their first event of each trace
+	pooledBuffer = nullptr;
+	pooledGeneration = generation;
+
+	for ( auto& slot : pool )
+	{
+		const auto	b = slot.load ( std::memory_order_acquire );
+
+		if ( b == nullptr )
+			break;
+
+		auto	expected = false;
+
+		if ( ! b->claimed.load ( std::memory_order_relaxed ) && b->claimed.compare_exchange_strong ( expected, true, std::memory_order_acq_rel ) )
+		{
+			b->threadId.store ( juce::uint64 ( juce::pointer_sized_int ( juce::Thread::getCurrentThreadId () ) ), std::memory_order_release );
+			pooledBuffer = b;
+			return b;
+		}
+	}
+
+	return nullptr;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogTrace::record ( const Event& e ) noexcept
+{
+	const auto	buffer = getThreadBuffer ();
+
+	if ( buffer == nullptr || ! buffer->push ( e ) )
+		droppedEvents.fetch_add ( 1, std::memory_order_relaxed );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogTrace::complete ( const char* name, juce::int64 startNs, juce::int64 endNs ) noexcept
+{
+	Event	e;
+	e.name = name;
+	e.timeNs = startNs;
+	e.durationNs = endNs - startNs;
+	e.phase = 'X';
+
+	record ( e );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogTrace::instant ( const char* name ) noexcept
+{
+	Event	e;
+	e.name = name;
+	e.timeNs = LogClock::now ();
+	e.phase = 'i';
+
+	record ( e );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogTrace::counter ( const char* name, double value ) noexcept
+{
+	Event	e;
+	e.name = name;
+	e.timeNs = LogClock::now ();
+	e.value = value;
+	e.phase = 'C';
+
+	record ( e );
+}
+//-------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+//-------------------------------------------------------------------------------------------------
+// Timing instrumentation, exported as Chrome trace JSON that chrome://tracing and Perfetto open.
+// Off until Logging::startTrace, then each event costs a clock read and a store into a buffer of
+// the calling thread. Names must be string literals or otherwise live until the trace is written.
+//
+// Recording never allocates or locks. A thread that did not call LogTrace::registerThread takes a
+// buffer from a pool that start () preallocates, and keeps it until the next trace starts. Once the
+// pool is used up, the events of further unregistered threads are dropped for the rest of the trace.
+
+#define	Z_TRACE_SCOPE(_name)			::reFX::LogTrace::Scope JUCE_JOIN_MACRO ( zTraceScope, __LINE__ ) ( _name )
+#define	Z_TRACE_INSTANT(_name)			{ if ( ::reFX::LogTrace::isEnabled () ) ::reFX::LogTrace::instant ( _name ); }
+#define	Z_TRACE_COUNTER(_name, _value)	{ if ( ::reFX::LogTrace::isEnabled () ) ::reFX::LogTrace::counter ( _name, double ( _value ) ); }
+
+namespace reFX
+{
+//-------------------------------------------------------------------------------------------------
+
+class LogTrace
+{
+public:
+	// Records into a new <time>.trace.json in the folder, replacing a running trace. Only the newest
+	// few trace files in the folder are kept.
+	static bool start ( const juce::File& folder );
+
+	// Writes what is still buffered and closes the file
+	static void stop ();
+
+	// Gives the calling thread its own buffer, named after the thread and freed after it exits.
+	// Allocates, so call it before the thread records on a real-time path.
+	static void registerThread ();
+
+	static bool isEnabled () noexcept				{ return enabled.load ( std::memory_order_relaxed ); }
+	static juce::File getFile ();
+	static juce::int64 getNumDroppedEvents ()		{ return droppedEvents; }
+
+	static void complete ( const char* name, juce::int64 startNs, juce::int64 endNs ) noexcept;
+	static void instant ( const char* name ) noexcept;
+	static void counter ( const char* name, double value ) noexcept;
+
+	// Times its own lifetime, see Z_TRACE_SCOPE
+	class Scope
+	{
+	public:
+		explicit Scope ( const char* n ) noexcept
+			: name ( n ), startSteadyNs ( isEnabled () ? LogClock::steadyNow () : 0 ) {}
+
+		// The duration comes from the monotonic clock, a recalibration in between does not change it
+		~Scope ()
+		{
+			if ( startSteadyNs == 0 )
+				return;
+
+			const auto	startNs = LogClock::toWallTime ( startSteadyNs );
+
+			complete ( name, startNs, startNs + LogClock::steadyNow () - startSteadyNs );
+		}
+
+	private:
+		const char*		name;
+		juce::int64		startSteadyNs;
+
+		JUCE_DECLARE_NON_COPYABLE ( Scope )
+	};
+
+private:
+	struct Event
+	{
+		const char*		name = nullptr;
+		juce::int64		timeNs = 0;
+		juce::int64		durationNs = 0;
+		double			value = 0.0;
+		char			phase = 'X';			// Chrome event type: X complete, i instant, C counter
+	};
+
+	class ThreadBuffer;
+	class Writer;
+
+	static void record ( const Event& ) noexcept;
+	static ThreadBuffer* getThreadBuffer () noexcept;
+
+	static constexpr int	poolSize = 8;
+
+	static inline std::atomic<bool>									enabled { false };
+	static inline std::atomic<juce::int64>							droppedEvents { 0 };
+	static inline std::array<std::atomic<ThreadBuffer*>, poolSize>	pool {};
+	static inline std::atomic<juce::uint32>							poolGeneration { 0 };		// Counts the traces, see start ()
+	static inline thread_local ThreadBuffer*						threadBuffer = nullptr;		// From registerThread
+	static inline thread_local ThreadBuffer*						pooledBuffer = nullptr;
+	static inline thread_local juce::uint32							pooledGeneration = 0;		// Trace in which pooledBuffer was taken
+};
+//-------------------------------------------------------------------------------------------------
+}
@@ -0,0 +1,564 @@
+#include "refx_LogWriter.h"
+#include "refx_BinaryLogFormat.h"
+#include "refx_LogFolderIndex.h"
+#include "refx_LogHousekeeper.h"
+#include "refx_LogSystemInfo.h"
+#include "refx_MappedLogFile.h"
+
+//-------------------------------------------------------------------------------------------------
+
+namespace reFX
+{
+
+LogWriter::LogWriter ()
+	: juce::Thread ( "reFX log writer" )
+{
+}
+//-------------------------------------------------------------------------------------------------
+
+LogWriter::~LogWriter ()
+{
+	{
+		juce::ScopedLock	sl ( queueLock );
+
+		queueing = false;
+	}
+
+	// Let the thread drain everything that is still queued before it exits
+	signalThreadShouldExit ();
+	wakeUp.signal ();
+	stopThread ( 10000 );
+
+	// Anything that arrived after the thread finished is written from here
+	drainQueue ();
+	flushStreamIfNeeded ( true );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogWriter::setOptions ( const LogWriterOptions& newOptions )
+{
+	{
+		juce::ScopedLock	sl ( streamLock );
+
+		options = newOptions;
+		applyRetention ();
+	}
+
+	if ( newOptions.asynchronous )
+	{
+		if ( ! isThreadRunning () )
+			startThread ( juce::Thread::Priority::low );
+
+		juce::ScopedLock	sl ( queueLock );
+
+		queueing = isThreadRunning ();
+	}
+	else if ( isThreadRunning () )
+	{
+		// From here on write () goes to the file itself, the drain below catches everything queued before
+		{
+			juce::ScopedLock	sl ( queueLock );
+
+			queueing = false;
+		}
+
+		signalThreadShouldExit ();
+		wakeUp.signal ();
+		stopThread ( 10000 );
+
+		drainQueue ();
+	}
+
+	wakeUp.signal ();
+}
+//-------------------------------------------------------------------------------------------------
+
+LogWriterOptions LogWriter::getOptions ()
+{
+	juce::ScopedLock	sl ( streamLock );
+
+	return options;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogWriter::setFolder ( const juce::File& f )
+{
+	// Messages queued for the old file still belong there
+	drainQueue ();
+
+	juce::ScopedLock	sl ( streamLock );
+
+	closeFile ();
+
+	folder = f;
+	mappingFailed = false;
+	sessionLock = nullptr;
+
+	if ( folder != juce::File () )
+	{
+		folder.createDirectory ();
+		index.scan ( folder );
+
+		// Mapped files of a session that crashed still end in unused zeros
+		for ( const auto& e : index.getEntries () )
+		{
+			const auto	size = MappedLogFile::recover ( e.file );
+
+			if ( size >= 0 && size != e.size )
+				index.setSize ( e.file, size );
+		}
+
+		openNewFile ();
+	}
+	else
+	{
+		index.clear ();
+	}
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::File LogWriter::getFolder ()
+{
+	juce::ScopedLock	sl ( streamLock );
+
+	return folder;
+}
+//-------------------------------------------------------------------------------------------------
+
+bool LogWriter::isOpen ()
+{
+	juce::ScopedLock	sl ( streamLock );
+
+	return stream != nullptr;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogWriter::setSystemInfo ( std::shared_ptr<LogSystemInfo> info )
+{
+	juce::ScopedLock	sl ( streamLock );
+
+	systemInfo = std::move ( info );
+}
+//-------------------------------------------------------------------------------------------------
+
+std::vector<LogFolderIndex::Entry> LogWriter::getLogFiles ()
+{
+	{
+		juce::ScopedLock	sl ( streamLock );
+
+		if ( stream )
+			index.setSize ( streamFile, stream->getPosition () );
+	}
+
+	return index.getEntries ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogWriter::write ( const LogMessage& msg )
+{
+	write ( &msg, 1 );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogWriter::write ( const LogMessage* messages, int numMessages )
+{
+	auto	sawError = false;
+
+	for ( int i = 0; i < numMessages; ++i )
+		sawError = sawError || messages[ i ].level == LogLevel::error;
+
+	auto	queued = false;
+	auto	wasEmpty = false;
+
+	{
+		juce::ScopedLock	sl ( queueLock );
+
+		if ( queueing )
+		{
+			wasEmpty = queue.empty ();
+			queue.insert ( queue.end (), messages, messages + numMessages );
+			queued = true;
+		}
+	}
+
+	if ( queued )
+	{
+		// A busy writer picks up new messages by itself, only wake it when it might be sleeping
+		if ( wasEmpty || sawError )
+			wakeUp.signal ();
+
+		return;
+	}
+
+	juce::ScopedLock	sl ( streamLock );
+
+	// Messages queued before the writer thread was stopped go first
+	drainQueue ();
+
+	const auto	startNs = LogClock::steadyNow ();
+
+	for ( int i = 0; i < numMessages; ++i )
+		writeToStream ( messages[ i ] );
+
+	writeLatency.add ( LogClock::steadyNow () - startNs );
+
+	flushStreamIfNeeded ( sawError && options.flushImmediatelyOnError );
+	rotateIfNeeded ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogWriter::flush ()
+{
+	drainQueue ();
+
+	juce::ScopedLock	sl ( streamLock );
+
+	flushStreamIfNeeded ( true );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogWriter::run ()
+{
+	while ( ! threadShouldExit () )
+	{
+		const auto	interval = getOptions ().flushIntervalMs;
+
+		wakeUp.wait ( interval > 0 ? double ( interval ) : -1.0 );
+
+		drainQueue ();
+
+		juce::ScopedLock	sl ( streamLock );
+
+		flushStreamIfNeeded ( false );
+		rotateIfNeeded ();
+	}
+
+	drainQueue ();
+
+	juce::ScopedLock	sl ( streamLock );
+
+	flushStreamIfNeeded ( true );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogWriter::drainQueue ()
+{
+	juce::ScopedLock	sl ( streamLock );
+
+	for (;;)
+	{
+		{
+			juce::ScopedLock	ql ( queueLock );
+
+			if ( queue.empty () )
+				break;
+
+			std::swap ( queue, batch );
+		}
+
+		auto		sawError = false;
+		const auto	startNs = LogClock::steadyNow ();
+
+		for ( const auto& msg : batch )
+		{
+			writeToStream ( msg );
+			sawError = sawError || msg.level == LogLevel::error;
+		}
+
+		writeLatency.add ( LogClock::steadyNow () - startNs );
+
+		batch.clear ();
+
+		flushStreamIfNeeded ( sawError && options.flushImmediatelyOnError );
+		rotateIfNeeded ();
+	}
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogWriter::writeToStream ( const LogMessage& msg )
+{
+	if ( ! stream )
+		return;
+
+	if ( machineInfoPending && systemInfo != nullptr )
+	{
+		const auto	machineInfo = systemInfo->getMachineInfo ( 0 );
+
+		if ( machineInfo.isNotEmpty () )
+		{
+			machineInfoPending = false;
+			writeInfo ( machineInfo );
+		}
+	}
+
+	if ( ! writeMessage ( msg ) )
+	{
+		// The message was not committed to the old file, it goes into the new one
+		if ( ! replaceFailedFile () || ! writeMessage ( msg ) )
+			return;
+	}
+
+	// Committing a mapped file is a store into memory, each message is complete right away
+	if ( streamMapped )
+		stream->flush ();
+	else
+		++unflushedMessages;
+}
+//-------------------------------------------------------------------------------------------------
+
+bool LogWriter::writeMessage ( const LogMessage& msg )
+{
+	const auto	start = stream->getPosition ();
+
+	if ( streamFormat == LogFileFormat::binary )
+	{
+		BinaryLogFormat::writeRecord ( *stream, msg );
+	}
+	else
+	{
+		msg.writeTo ( *stream );
+		stream->write ( "\r\n", 2 );
+	}
+
+	bytesWritten.fetch_add ( stream->getPosition () - start, std::memory_order_relaxed );
+
+	if ( streamMapped )
+		return ! static_cast<MappedLogFile&> ( *stream ).writeFailed ();
+
+	return static_cast<juce::FileOutputStream&> ( *stream ).getStatus ().wasOk ();
+}
+//-------------------------------------------------------------------------------------------------
+
+bool LogWriter::replaceFailedFile ()
+{
+	const auto	now = juce::Time::getMillisecondCounter ();
+
+	// A full disk fails the next file as well, it should not get a new one for every message
+	if ( ! streamMapped && now - lastReplaceTime < 10000 )
+		return false;
+
+	lastReplaceTime = now;
+
+	// A mapped file that could not grow, plain files are written from now on
+	if ( streamMapped )
+		mappingFailed = true;
+
+	closeFile ();
+	openNewFile ();
+
+	return stream != nullptr;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogWriter::flushStreamIfNeeded ( bool force )
+{
+	if ( ! stream || unflushedMessages == 0 )
+		return;
+
+	const auto	now = juce::Time::getMillisecondCounter ();
+
+	if ( ! force )
+	{
+		const auto	countDue = options.flushEveryMessages > 0 && unflushedMessages >= options.flushEveryMessages;
+		const auto	timeDue = options.flushIntervalMs > 0 && now - lastFlushTime >= juce::uint32 ( options.flushIntervalMs );
+
+		if ( ! countDue && ! timeDue )
+			return;
+	}
+
+	const auto	startNs = LogClock::steadyNow ();
+
+	stream->flush ();
+
+	flushLatency.add ( LogClock::steadyNow () - startNs );
+
+	unflushedMessages = 0;
+	lastFlushTime = now;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogWriter::rotateIfNeeded ()
+{
+	if ( ! stream )
+		return;
+
+	const auto	sizeDue = options.maxFileBytes > 0 && stream->getPosition () >= options.maxFileBytes;
+	const auto	timeDue = options.rotationIntervalSeconds > 0 && juce::Time::getMillisecondCounter () - streamOpenedTime >= juce::uint32 ( options.rotationIntervalSeconds ) * 1000;
+
+	if ( ! sizeDue && ! timeDue )
+		return;
+
+	const auto	finished = streamFile;
+
+	closeFile ();
+	openNewFile ();
+
+	if ( options.compressOldFiles )
+		compressInBackground ( finished );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogWriter::openNewFile ()
+{
+	const auto	extension = options.format == LogFileFormat::binary ? BinaryLogFormat::fileExtension : ".txt";
+	const auto	file = folder.getChildFile ( juce::Time::getCurrentTime ().toISO8601 ( false ) + extension ).getNonexistentSibling ();
+
+	if ( options.memoryMapped && ! mappingFailed )
+	{
+		// Keeps other processes that share the folder from recovering the files of this session
+		if ( sessionLock == nullptr )
+		{
+			sessionLock = std::make_unique<juce::InterProcessLock> ( MappedLogFile::getSessionLockName ( folder ) );
+			sessionLock->enter ( 0 );
+		}
+
+		auto	mapped = std::make_unique<MappedLogFile> ( file );
+
+		if ( mapped->openedOk () )
+			stream = std::move ( mapped );
+		else
+			mappingFailed = true;
+	}
+
+	streamMapped = stream != nullptr;
+
+	if ( ! streamMapped )
+	{
+		auto	out = std::make_unique<juce::FileOutputStream> ( file );
+
+		// A mapping that failed may have left zeros in the file
+		if ( out->failedToOpen () || ! out->setPosition ( 0 ) || out->truncate ().failed () )
+			return;
+
+		stream = std::move ( out );
+	}
+
+	streamFile = file;
+	streamFormat = options.format;
+	streamOpenedTime = juce::Time::getMillisecondCounter ();
+
+	if ( streamFormat == LogFileFormat::binary )
+		BinaryLogFormat::writeFileHeader ( *stream );
+
+	machineInfoPending = false;
+
+	if ( options.writeSystemInfo && systemInfo != nullptr )
+		writeHeader ();
+
+	if ( streamMapped )
+		stream->flush ();
+
+	index.add ( file );
+
+	applyRetention ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogWriter::writeHeader ()
+{
+	// The first file is opened at startup, maybe by the message thread. It does not wait for the
+	// background thread, the machine info goes in before the first message logged after it is done.
+	const auto	machineInfo = systemInfo->getMachineInfo ( 0 );
+
+	machineInfoPending = machineInfo.isEmpty ();
+
+	writeInfo ( machineInfo + systemInfo->getDisplayInfo () );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogWriter::writeInfo ( const juce::String& info )
+{
+	if ( info.isEmpty () )
+		return;
+
+	const auto	lines = juce::StringArray::fromLines ( info.trimEnd () );
+
+	// Binary files only hold records, each line becomes an info message there
+	if ( streamFormat == LogFileFormat::binary )
+	{
+		for ( const auto& line : lines )
+			BinaryLogFormat::writeRecord ( *stream, { line, LogLevel::info } );
+
+		return;
+	}
+
+	for ( const auto& line : lines )
+		stream->writeText ( line + "\r\n", false, false, nullptr );
+
+	stream->writeText ( "------------------------------------------------------------------------------\r\n", false, false, nullptr );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogWriter::closeFile ()
+{
+	if ( ! stream )
+		return;
+
+	flushStreamIfNeeded ( true );
+
+	index.setSize ( streamFile, stream->getPosition () );
+
+	// Cuts a mapped file to its used size
+	stream = nullptr;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogWriter::applyRetention ()
+{
+	if ( ! stream )
+		return;
+
+	// Deleting files can take a while, the index already forgets them right now
+	const auto	expired = index.removeExpired ( options.maxFiles, options.maxTotalBytes, streamFile );
+
+	if ( ! expired.isEmpty () )
+		housekeeper.addJob ( [ expired ] { for ( const auto& f : expired ) f.deleteFile (); } );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogWriter::compressInBackground ( const juce::File& source )
+{
+	housekeeper.addJob ( [ this, source ]
+	{
+		// Expired in the meantime
+		if ( ! source.existsAsFile () )
+			return;
+
+		const auto	target = source.getSiblingFile ( source.getFileName () + BinaryLogFormat::compressedFileExtension );
+
+		auto	ok = false;
+
+		{
+			juce::FileInputStream	in ( source );
+			juce::FileOutputStream	out ( target );
+
+			if ( in.openedOk () && out.openedOk () && out.truncate ().wasOk () )
+			{
+				juce::GZIPCompressorOutputStream	gz ( out, 9, juce::GZIPCompressorOutputStream::windowBitsGZIP );
+
+				ok = gz.writeFromInputStream ( in, -1 ) == in.getTotalLength ();
+			}
+		}
+
+		if ( ! ok )
+		{
+			target.deleteFile ();
+			return;
+		}
+
+		// Retention counts the compressed size from now on. If the file expired while it was
+		// being compressed, the result is not needed anymore.
+		if ( index.replace ( source, target, target.getSize () ) )
+		{
+			source.deleteFile ();
+		}
+		else
+		{
+			target.deleteFile ();
+			source.deleteFile ();
+		}
+	} );
+}
+//-------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+namespace reFX
+{
+//-------------------------------------------------------------------------------------------------
+
+class LogWriter
+	: private juce::Thread
+{
+public:
+	LogWriter ();
+	~LogWriter () override;
+
+	void setOptions ( const LogWriterOptions& );
+	LogWriterOptions getOptions ();
+
+	// Starts a new log file in the folder, an empty File closes the log
+	void setFolder ( const juce::File& );
+	juce::File getFolder ();
+	bool isOpen ();
+
+	// Source of the header each file starts with, see LogWriterOptions::writeSystemInfo
+	void setSystemInfo ( std::shared_ptr<LogSystemInfo> );
+
+	std::vector<LogFolderIndex::Entry> getLogFiles ();
+
+	void write ( const LogMessage& );
+	void write ( const LogMessage* messages, int numMessages );
+	void flush ();
+
+	// Self-instrumentation, see Logging::getStats
+	juce::int64 getBytesWritten () const						{ return bytesWritten; }
+	LogLatencyHistogram::Snapshot getWriteLatency () const		{ return writeLatency.getSnapshot (); }
+	LogLatencyHistogram::Snapshot getFlushLatency () const		{ return flushLatency.getSnapshot (); }
+
+private:
+	void run () override;
+
+	void drainQueue ();
+	void writeToStream ( const LogMessage& );
+	bool writeMessage ( const LogMessage& );
+	bool replaceFailedFile ();
+	void flushStreamIfNeeded ( bool force );
+
+	void rotateIfNeeded ();
+	void openNewFile ();
+	void writeHeader ();
+	void writeInfo ( const juce::String& );
+	void closeFile ();
+	void applyRetention ();
+	void compressInBackground ( const juce::File& );
+
+	juce::CriticalSection					streamLock;
+	juce::File								folder;
+	std::unique_ptr<juce::InterProcessLock>	sessionLock;	// Held while mapped files in the folder are open, outlives stream
+	std::unique_ptr<juce::OutputStream>		stream;		// juce::FileOutputStream or MappedLogFile
+	juce::File								streamFile;
+	LogFileFormat							streamFormat = LogFileFormat::text;
+	bool									streamMapped = false;
+	bool									mappingFailed = false;		// Plain files until the folder changes, see replaceFailedFile
+	juce::uint32							lastReplaceTime = 0;
+	juce::uint32							streamOpenedTime = 0;
+	LogWriterOptions						options;
+	std::shared_ptr<LogSystemInfo>			systemInfo;
+	bool									machineInfoPending = false;		// Not gathered yet when the file was opened
+	int										unflushedMessages = 0;
+	juce::uint32							lastFlushTime = 0;
+
+	std::atomic<juce::int64>				bytesWritten { 0 };
+	LogLatencyHistogram						writeLatency;
+	LogLatencyHistogram						flushLatency;
+
+	juce::CriticalSection					queueLock;
+	bool									queueing = false;		// Set while the thread runs, write () decides under queueLock
+	std::vector<LogMessage>					queue;
+	std::vector<LogMessage>					batch;
+	juce::WaitableEvent						wakeUp;
+
+	LogFolderIndex							index;
+	LogHousekeeper							housekeeper;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR ( LogWriter )
+};
+//-------------------------------------------------------------------------------------------------
+}
@@ -1,6 +1,17 @@
+#include <cstdio>
+#include <cstring>
 #include <ctime>
 
 #include "refx_LoggingWindow.h"
+#include "refx_LogCategory.h"
+#include "refx_LogWriter.h"
+#include "refx_RealtimeLog.h"
+#include "refx_BinaryLogFormat.h"
+#include "refx_MappedLogFile.h"
+#include "refx_LogHistory.h"
+#include "refx_LogRowCache.h"
+#include "refx_LogSink.h"
+#include "refx_LogSinks.h"
 
 //-------------------------------------------------------------------------------------------------
 
@@ -8,31 +19,205 @@ namespace reFX
 {
 JUCE_IMPLEMENT_SINGLETON ( Logging )
 
+// Set while this thread holds the delivery lock. Messages that sinks and listeners log from there
+// cannot wait for room, nobody else can deliver until they return.
+static thread_local bool	deliveringOnThisThread = false;
+
 //-------------------------------------------------------------------------------------------------
 
-juce::String LogMessage::toString ()
+// Formats into a per-thread buffer that stays valid until the next call on the same thread
+static const char* formatTime ( juce::int64 timeNs )
 {
-	// Compose final message
-	char	dstTime[ 100 ] = { 0 };
-	std::strftime ( dstTime, sizeof ( dstTime ), "%T", std::localtime ( &timeStamp ) );
+	const auto	seconds = time_t ( timeNs / 1000000000 );
+	auto		micros = int ( ( timeNs / 1000 ) % 1000000 );
+
+	// Most messages share their second with the previous one, so localtime/strftime rarely run
+	thread_local time_t	lastTime = -1;
+	thread_local char	text[ 100 ] = { 0 };
+	thread_local size_t	secondsLength = 0;
+
+	if ( seconds != lastTime )
+	{
+		secondsLength = std::strftime ( text, sizeof ( text ) - 8, "%T", std::localtime ( &seconds ) );
+		lastTime = seconds;
+	}
+
+	auto	p = text + secondsLength;
+	*p++ = '.';
+
+	for ( int i = 6; --i >= 0; micros /= 10 )
+		p[ i ] = char ( '0' + micros % 10 );
+
+	p[ 6 ] = 0;
+
+	return text;
+}
+//-------------------------------------------------------------------------------------------------
 
-	juce::String code;
+static const char* getLevelCode ( LogLevel level )
+{
 	switch ( level )
 	{
-		case LogLevel::log: 		code = "LOG "; break;
-		case LogLevel::info: 		code = "INFO"; break;
-		case LogLevel::warning: 	code = "WARN"; break;
-		case LogLevel::error: 		code = "ERR "; break;
-		case LogLevel::debuglog: 	code = "DLOG"; break;
-		default: jassertfalse; 		code = "   "; break;
+		case LogLevel::log: 		return "LOG ";
+		case LogLevel::info: 		return "INFO";
+		case LogLevel::warning: 	return "WARN";
+		case LogLevel::error: 		return "ERR ";
+		case LogLevel::debuglog: 	return "DLOG";
+		default: jassertfalse; 		return "    ";
+	}
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String LogMessage::getTimeString () const
+{
+	return formatTime ( timeNs );
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String LogMessage::getThreadString () const
+{
+	return threadName.isNotEmpty () ? threadName : "0x" + juce::String::toHexString ( juce::int64 ( threadId ) );
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String LogMessage::getCurrentThreadName ()
+{
+	thread_local const juce::String	name = []
+	{
+		if ( auto t = juce::Thread::getCurrentThread () )
+			return t->getThreadName ();
+
+		if ( juce::MessageManager::existsAndIsCurrentThread () )
+			return juce::String ( "Message" );
+
+		return juce::String ();
+	}();
+
+	return name;
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String LogMessage::toString () const
+{
+	// Compose final message
+	thread_local juce::MemoryOutputStream	buffer;
+
+	buffer.reset ();
+	writeTo ( buffer );
+
+	return juce::String::fromUTF8 ( static_cast<const char*> ( buffer.getData () ), int ( buffer.getDataSize () ) );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LogMessage::writeTo ( juce::OutputStream& out ) const
+{
+	const auto	time = formatTime ( timeNs );
+
+	out.write ( time, std::strlen ( time ) );
+	out.write ( ": ", 2 );
+	out.write ( getLevelCode ( level ), 4 );
+	out.write ( " [", 2 );
+
+	if ( threadName.isNotEmpty () )
+	{
+		out.write ( threadName.toRawUTF8 (), threadName.getNumBytesAsUTF8 () );
+	}
+	else
+	{
+		char	id[ 24 ];
+		out.write ( id, size_t ( std::snprintf ( id, sizeof ( id ), "0x%llx", (unsigned long long) threadId ) ) );
+	}
+
+	out.write ( "] - ", 4 );
+	out.write ( description.toRawUTF8 (), description.getNumBytesAsUTF8 () );
+}
+//-------------------------------------------------------------------------------------------------
+
+static std::atomic<LogCallSite*>	firstCallSite { nullptr };
+
+void LogCallSite::registerSite () noexcept
+{
+	// Several threads can reach a new site at once, only one of them adds it
+	if ( registered.exchange ( true, std::memory_order_acq_rel ) )
+		return;
+
+	next = firstCallSite.load ( std::memory_order_relaxed );
+
+	while ( ! firstCallSite.compare_exchange_weak ( next, this, std::memory_order_release, std::memory_order_relaxed ) )
+	{
 	}
+}
+//-------------------------------------------------------------------------------------------------
 
-	return juce::String ( dstTime ) + ": " + code + " - " + description;
+std::vector<LogCallSite*> LogCallSite::getAll ()
+{
+	std::vector<LogCallSite*>	sites;
+
+	// Sites are only ever added at the front, so the list can be walked while it grows
+	for ( auto s = firstCallSite.load ( std::memory_order_acquire ); s != nullptr; s = s->next )
+		sites.push_back ( s );
+
+	return sites;
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String LogCallSite::getFileName () const
+{
+	return juce::String ( file ).fromLastOccurrenceOf ( "/", false, false ).fromLastOccurrenceOf ( "\\", false, false );
+}
+//-------------------------------------------------------------------------------------------------
+
+Logging::Logging ()
+	: realtimeQueue ( std::make_unique<LogQueue<RealtimeLogEntry>> ( REFX_RT_LOG_QUEUE_SIZE ) )
+	, history ( std::make_unique<LogHistory> ( REFX_LOG_HISTORY_SIZE ) )
+	, systemInfo ( std::make_shared<LogSystemInfo> () )
+	, sinks ( std::make_unique<LogSinkDispatcher> () )
+	, fileSink ( std::make_shared<FileLogSink> () )
+{
+	fileSink->getWriter ().setSystemInfo ( systemInfo );
+
+	if ( juce::MessageManager::existsAndIsCurrentThread () )
+		systemInfo->updateDisplays ();
+
+	sinks->add ( fileSink );
+	sinks->add ( std::make_shared<ListenerLogSink> ( *this ) );
+
+#if REFX_LOG_DEBUG_OUTPUT
+	debugOutputSink = std::make_shared<DebugOutputLogSink> ();
+	sinks->add ( debugOutputSink );
+#endif
+
+	// Real-time threads cannot wake anybody up, so their messages are collected periodically
+	startTimer ( 50 );
 }
 //-------------------------------------------------------------------------------------------------
 
 Logging::~Logging ()
 {
+	stopTimer ();
+	stopTrace ();
+	drainRealtimeQueue ();
+
+	// Nobody listens anymore, but the sinks still get what is left in the queue
+	for ( LogMessage msg; queue.pop ( msg ); )
+	{
+		if ( collapseRepeat ( msg ) )
+			continue;
+
+		msg.sequence = ++lastSequence;
+		deliveryBatch.push_back ( std::move ( msg ) );
+	}
+
+	addRepeatSummary ();
+
+	if ( ! deliveryBatch.empty () )
+		sinks->deliver ( deliveryBatch.data (), deliveryBatch.size () );
+
+	// Writes what the asynchronous sinks still have, then the log file drains and flushes its queue
+	sinks = nullptr;
+	debugOutputSink = nullptr;
+	fileSink = nullptr;
+
 	clearSingletonInstance ();
 }
 //-------------------------------------------------------------------------------------------------
@@ -49,34 +234,255 @@ void Logging::removeListener ( Listener* l )
 }
 //----------------------------------------------------------------------------------
 
-void Logging::logMessage ( const juce::String& messageText, const LogLevel msgLevel )
+void Logging::logMessage ( const juce::String& messageText, const LogLevel msgLevel, LogCallSite* site )
+{
+	logMessage ( juce::String ( messageText ), msgLevel, site );
+}
+//-------------------------------------------------------------------------------------------------
+
+void Logging::logMessage ( juce::String&& messageText, const LogLevel msgLevel, LogCallSite* site )
 {
+	// Also gates direct calls and juce::Logger::writeToLog, which bypass the macros
+	if ( site != nullptr ? ! site->isLevelEnabled ( msgLevel ) : ! isLevelEnabled ( msgLevel ) )
+	{
+		filteredMessages.fetch_add ( 1, std::memory_order_relaxed );
+		return;
+	}
+
 	auto	self = Logging::getInstance ();
 
-	juce::ScopedLock	sl ( self->lock );
+	self->drainRealtimeQueue ();
+	LogMessage	msg { std::move ( messageText ), msgLevel };
+	msg.site = site;
+
+	self->enqueue ( std::move ( msg ) );
+	self->deliverQueuedMessages ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void Logging::timerCallback ()
+{
+	// Keeps the monotonic clock in step with adjustments of the system clock
+	if ( ++timerTicks % 1200 == 0 )
+		LogClock::recalibrate ();
+
+	// Reading the cached display list is cheap, there is no notification when it changes
+	if ( timerTicks % 40 == 1 )
+		systemInfo->updateDisplays ();
+
+	drainRealtimeQueue ();
+	deliverQueuedMessages ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void Logging::drainRealtimeQueue ()
+{
+	if ( realtimeQueue->isEmpty () )
+		return;
 
-	LogMessage	msg = { messageText, msgLevel };
+	juce::SpinLock::ScopedTryLockType	stl ( realtimeDrainLock );
 
-	self->messages.add ( msg );
-	self->triggerAsyncUpdate ();
+	if ( ! stl.isLocked () )
+		return;
 
-	if ( self->logStream )
+	for ( RealtimeLogEntry entry; realtimeQueue->pop ( entry ); )
 	{
-		self->logStream->writeText ( msg.toString () + "\r\n", false, false, nullptr );
-		self->logStream->flush ();
+		LogMessage	msg = { formatLogMessage ( entry.format, entry.args, entry.numArgs ), entry.level };
+		msg.timeNs = entry.timeNs;
+		msg.threadId = entry.threadId;
+		msg.threadName = {};	// Not known on the real-time thread, the id is shown instead
+		msg.site = entry.site;
+
+		enqueue ( std::move ( msg ) );
 	}
+}
+//-------------------------------------------------------------------------------------------------
+
+void Logging::enqueue ( LogMessage&& msg )
+{
+	if ( queue.push ( std::move ( msg ) ) )
+		return;
+
+	noteQueueDepth ( queue.getCapacity () );
+
+	switch ( overflowPolicy.load () )
+	{
+		case LogOverflowPolicy::dropNewest:
+			++droppedMessages;
+			break;
+
+		case LogOverflowPolicy::dropOldest:
+			for ( LogMessage oldest; ! queue.push ( std::move ( msg ) ); )
+				if ( queue.pop ( oldest ) )
+					++droppedMessages;
+			break;
+
+		case LogOverflowPolicy::block:
+		{
+			if ( deliveringOnThisThread )
+			{
+				++droppedMessages;
+				break;
+			}
+
+			const auto	startNs = LogClock::steadyNow ();
+
+			while ( ! queue.push ( std::move ( msg ) ) )
+			{
+				deliverQueuedMessages ();
+				juce::Thread::yield ();
+			}
+
+			blockedTime.add ( LogClock::steadyNow () - startNs );
+			break;
+		}
+
+		default:
+			jassertfalse;
+			break;
+	}
+}
+//-------------------------------------------------------------------------------------------------
+
+void Logging::deliverQueuedMessages ()
+{
+	// Whoever gets the lock delivers for everybody, the others just leave their message in the queue.
+	// The re-check after unlocking catches messages pushed while the lock was being released.
+	// The lock is not re-entrant, so a message logged during delivery is picked up by the running loop.
+	do
+	{
+		juce::SpinLock::ScopedTryLockType	stl ( deliveryLock );
+
+		if ( ! stl.isLocked () )
+			return;
+
+		const juce::ScopedValueSetter<bool>	delivering ( deliveringOnThisThread, true );
+
+		// Sampled once per delivery, a full queue is noted when a push fails
+		noteQueueDepth ( queue.getNumQueued () );
+
+		const auto	startNs = LogClock::steadyNow ();
+		auto		delivered = false;
 
-	outputDebugString ( msg.toString () );
+		for (;;)
+		{
+			for ( LogMessage msg; deliveryBatch.size () < 256 && queue.pop ( msg ); )
+			{
+				loggedMessages[ size_t ( msg.level ) ].fetch_add ( 1, std::memory_order_relaxed );
+
+				if ( collapseRepeat ( msg ) )
+					continue;
+
+				msg.sequence = ++lastSequence;
+				deliveryBatch.push_back ( std::move ( msg ) );
+			}
+
+			// Shows the count once the repeats stopped, even if nothing else is logged
+			if ( deliveryBatch.empty () && numRepeats > 0 && LogClock::now () - lastRepeat.timeNs >= repeatSummaryNs )
+				addRepeatSummary ();
+
+			if ( deliveryBatch.empty () )
+				break;
+
+			{
+				juce::ScopedLock	sl ( lock );
+
+				for ( const auto& msg : deliveryBatch )
+					history->add ( msg );
+			}
+
+			sinks->deliver ( deliveryBatch.data (), deliveryBatch.size () );
 
-	juce::MessageManager::callAsync ( [ self, msg ]
+			// One pending update for the window and all listeners, no matter how many messages arrive
+			triggerAsyncUpdate ();
+
+			deliveryBatch.clear ();
+			delivered = true;
+		}
+
+		if ( delivered )
+			deliveryTime.add ( LogClock::steadyNow () - startNs );
+	}
+	while ( ! queue.isEmpty () );
+}
+//-------------------------------------------------------------------------------------------------
+
+bool Logging::collapseRepeat ( LogMessage& msg )
+{
+	if ( collapseRepeats && lastSequence > 0 && msg.level == lastDeliveredLevel && msg.description == lastDeliveredText )
 	{
-		self->listeners.call ( [ msg ] ( Listener& l ) { l.messageLogged ( msg ); } );
-	} );
+		if ( numRepeats++ == 0 )
+			repeatStartNs = msg.timeNs;
+
+		repeatsCollapsed.fetch_add ( 1, std::memory_order_relaxed );
+
+		lastRepeat = std::move ( msg );
+
+		// A flood still shows up once per interval
+		if ( lastRepeat.timeNs - repeatStartNs >= repeatSummaryNs )
+			addRepeatSummary ();
+
+		return true;
+	}
+
+	addRepeatSummary ();
+
+	lastDeliveredText = msg.description;
+	lastDeliveredLevel = msg.level;
+
+	return false;
+}
+//-------------------------------------------------------------------------------------------------
+
+void Logging::addRepeatSummary ()
+{
+	if ( numRepeats == 0 )
+		return;
+
+	LogMessage	summary { "Last message repeated " + juce::String ( numRepeats ) + ( numRepeats == 1 ? " time" : " times" ), lastRepeat.level };
+	summary.timeNs = lastRepeat.timeNs;
+	summary.threadId = lastRepeat.threadId;
+	summary.threadName = lastRepeat.threadName;
+	summary.sequence = ++lastSequence;
+
+	deliveryBatch.push_back ( std::move ( summary ) );
+	numRepeats = 0;
+}
+//-------------------------------------------------------------------------------------------------
+
+void Logging::noteQueueDepth ( int numQueued )
+{
+	for ( auto high = queueHighWater.load ( std::memory_order_relaxed ); numQueued > high && ! queueHighWater.compare_exchange_weak ( high, numQueued, std::memory_order_relaxed ); )
+		;
+}
+//-------------------------------------------------------------------------------------------------
+
+void Logging::queueForListeners ( const LogMessage* messages, int numMessages )
+{
+	juce::ScopedLock	sl ( listenerQueueLock );
+
+	listenerQueue.insert ( listenerQueue.end (), messages, messages + numMessages );
 }
 //-------------------------------------------------------------------------------------------------
 
 void Logging::handleAsyncUpdate ()
 {
+	juce::Array<LogMessage>	batch;
+
+	{
+		juce::ScopedLock	sl ( listenerQueueLock );
+
+		batch.ensureStorageAllocated ( int ( listenerQueue.size () ) );
+
+		for ( auto& msg : listenerQueue )
+			batch.add ( std::move ( msg ) );
+
+		listenerQueue.clear ();
+	}
+
+	if ( ! batch.isEmpty () )
+		listeners.call ( [ &batch ] ( Listener& l ) { l.messagesLogged ( batch ); } );
+
 	if ( loggingWindow )
 		loggingWindow->update ();
 }
@@ -86,7 +492,49 @@ juce::Array<LogMessage> Logging::getMessages ()
 {
 	juce::ScopedLock sl ( lock );
 
-	return messages;
+	return history->getMessages ();
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::uint64 Logging::getMessagesSince ( juce::uint64 sequence, juce::Array<LogMessage>& dest )
+{
+	juce::ScopedLock sl ( lock );
+
+	history->getMessagesAfter ( sequence, dest );
+
+	return juce::jmax ( sequence, history->getNewestSequence () );
+}
+//-------------------------------------------------------------------------------------------------
+
+void Logging::setHistoryCapacity ( int numMessages )
+{
+	// Building the slots and freeing the old ones would stall delivery, only the move is locked.
+	// The lock is released before the old history, swapped into other, is destroyed.
+	auto	other = std::make_unique<LogHistory> ( numMessages );
+
+	juce::ScopedLock sl ( lock );
+
+	if ( other->getCapacity () == history->getCapacity () )
+		return;
+
+	other->takeNewest ( *history );
+	std::swap ( history, other );
+}
+//-------------------------------------------------------------------------------------------------
+
+int Logging::getHistoryCapacity ()
+{
+	juce::ScopedLock sl ( lock );
+
+	return history->getCapacity ();
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::uint64 Logging::getOldestRetainedSequence ()
+{
+	juce::ScopedLock sl ( lock );
+
+	return history->getOldestSequence ();
 }
 //-------------------------------------------------------------------------------------------------
 
@@ -114,29 +562,80 @@ bool Logging::isLoggingWindowVisible ()
 }
 //-------------------------------------------------------------------------------------------------
 
+LogRowCache& Logging::getRowCache ()
+{
+	if ( ! rowCache )
+		rowCache = std::make_unique<LogRowCache> ();
+
+	return *rowCache;
+}
+//-------------------------------------------------------------------------------------------------
+
 void Logging::setLogFolder ( const juce::File& f )
 {
-	juce::ScopedLock	sl ( lock );
+	fileSink->getWriter ().setFolder ( f );
+}
+//-------------------------------------------------------------------------------------------------
 
-	if ( f != juce::File () )
-	{
-		f.createDirectory ();
+bool Logging::startTrace ()
+{
+	const auto	folder = fileSink->getWriter ().getFolder ();
+
+	if ( folder == juce::File () )
+		return false;
 
-		auto	files = f.findChildFiles ( juce::File::findFiles, true, "*", juce::File::FollowSymlinks::noCycles );
-		std::sort ( files.begin (), files.end (), [] ( const auto& lhs, const auto& rhs ) { return lhs.getCreationTime () < rhs.getCreationTime (); } );
+	if ( ! LogTrace::start ( folder.getChildFile ( "Traces" ) ) )
+		return false;
 
-		while ( files.size () > 3 )
-			files.removeAndReturn ( 0 ).deleteFile ();
+	Z_INFO ( "Trace started: " + LogTrace::getFile ().getFullPathName () );
+	return true;
+}
+//-------------------------------------------------------------------------------------------------
 
-		auto	logFile = f.getChildFile ( juce::Time::getCurrentTime ().toISO8601 ( false ) + ".txt" );
-		logStream = std::make_unique<juce::FileOutputStream> ( logFile );
-	}
-	else
-	{
-		logStream = nullptr;
-	}
+void Logging::stopTrace ()
+{
+	if ( ! LogTrace::isEnabled () )
+		return;
+
+	const auto	file = LogTrace::getFile ();
+	const auto	dropped = LogTrace::getNumDroppedEvents ();
+
+	LogTrace::stop ();
 
-	logFolder = f;
+	Z_INFO ( "Trace written: " + file.getFullPathName () + ( dropped > 0 ? " (" + juce::String ( dropped ) + " events dropped)" : juce::String () ) );
+}
+//-------------------------------------------------------------------------------------------------
+
+void Logging::setLogLevel ( LogLevel l )
+{
+	activeLevel = int ( l );
+
+	// Categories without a level of their own follow the global one
+	LogCategory::updateLevels ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void Logging::setWriterOptions ( const LogWriterOptions& o )
+{
+	fileSink->getWriter ().setOptions ( o );
+}
+//-------------------------------------------------------------------------------------------------
+
+LogWriterOptions Logging::getWriterOptions ()
+{
+	return fileSink->getWriter ().getOptions ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void Logging::addSink ( std::shared_ptr<LogSink> sink )
+{
+	sinks->add ( std::move ( sink ) );
+}
+//-------------------------------------------------------------------------------------------------
+
+void Logging::removeSink ( const std::shared_ptr<LogSink>& sink )
+{
+	sinks->remove ( sink );
 }
 //-------------------------------------------------------------------------------------------------
 
@@ -156,6 +655,34 @@ juce::String Logging::getLogLevelName ( LogLevel l )
 }
 //-------------------------------------------------------------------------------------------------
 
+LogStats Logging::getStats ()
+{
+	LogStats	s;
+
+	for ( size_t i = 0; i < s.messages.size (); ++i )
+		s.messages[ i ] = loggedMessages[ i ].load ( std::memory_order_relaxed );
+
+	s.repeatsCollapsed = repeatsCollapsed;
+	s.filtered = filteredMessages;
+	s.rateLimited = LogRateLimit::totalSuppressed;
+	s.dropped = droppedMessages;
+	s.droppedRealtime = droppedRealtimeMessages;
+	s.queueHighWater = queueHighWater;
+	s.queueCapacity = queue.getCapacity ();
+
+	auto&	writer = fileSink->getWriter ();
+
+	s.bytesWritten = writer.getBytesWritten ();
+	s.writeLatency = writer.getWriteLatency ();
+	s.flushLatency = writer.getFlushLatency ();
+
+	s.deliveryTime = deliveryTime.getSnapshot ();
+	s.blockedTime = blockedTime.getSnapshot ();
+
+	return s;
+}
+//-------------------------------------------------------------------------------------------------
+
 juce::String Logging::getSystemStats ()
 {
 	juce::String	text;
@@ -163,104 +690,220 @@ juce::String Logging::getSystemStats ()
 	if ( creatorString.isNotEmpty () )
 		text += "Creator:   " + creatorString + "\r\n";
 
-	text += "Location:  " + juce::File::getSpecialLocation ( juce::File::currentApplicationFile ).getFullPathName () + "\r\n";
-	text += "Timestamp: " + juce::Time::getCurrentTime ().toString ( true, true, true, true ) + "\r\n\r\n";
+	text += "Timestamp: " + juce::Time::getCurrentTime ().toString ( true, true, true, true ) + "\r\n";
+
+	// Gathered in the background at startup, the displays are refreshed by the timer
+	text += systemInfo->getSummary ();
 
-	//
-	// Computer specific
-	//
-	auto isCurrentUserAdmin = [] () -> bool
+	// Shows whether the logging itself was the bottleneck
+	text += "\r\n" + getStats ().toString ();
+
+	if ( additionalSystemStats )
+		text += additionalSystemStats ();
+
+	text += "------------------------------------------------------------------------------\r\n\r\n";
+
+	return text;
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String Logging::getAsString ()
+{
+	juce::MemoryOutputStream	text;
+
+	writeSupportInfo ( text );
+
+	return text.toUTF8 ();
+}
+//-------------------------------------------------------------------------------------------------
+
+// The housekeeper may have compressed the file since the list was taken
+static std::unique_ptr<juce::InputStream> openLogFile ( const juce::File& f )
+{
+	if ( auto in = BinaryLogFormat::openFile ( f ) )
+		return in;
+
+	return BinaryLogFormat::openFile ( f.getSiblingFile ( f.getFileName () + BinaryLogFormat::compressedFileExtension ) );
+}
+//-------------------------------------------------------------------------------------------------
+
+static juce::String getUnreadableFileNote ( const juce::File& f )
+{
+	return "Could not read " + f.getFullPathName () + "\r\n";
+}
+//-------------------------------------------------------------------------------------------------
+
+bool Logging::writeSupportInfo ( juce::OutputStream& out, const std::function<bool ( double )>& progress )
+{
+	auto	keepGoing = [ &progress ] ( double p ) { return ! progress || progress ( juce::jlimit ( 0.0, 1.0, p ) ); };
+
+	if ( ! out.writeText ( getSystemStats (), false, false, nullptr ) )
+		return false;
+
+	auto&	writer = fileSink->getWriter ();
+
+	// The log files are the complete record, the history only has the newest messages
+	if ( ! writer.isOpen () )
+		return writeRetainedMessages ( out, keepGoing );
+
+	// Make sure the current file contains everything that is still queued
+	sinks->flush ();
+
+	const auto	files = writer.getLogFiles ();
+
+	juce::int64	total = 0;
+	juce::int64	done = 0;
+
+	for ( const auto& entry : files )
+		total += juce::jmax ( juce::int64 ( 1 ), entry.size );
+
+	for ( const auto& entry : files )
 	{
-		#if JUCE_MAC || JUCE_LINUX
-			juce::ChildProcess cp;
-			cp.start ( { "id", "-u" } );
-			cp.waitForProcessToFinish ( 100 );
-
-			auto output = cp.readAllProcessOutput ().trim ();
-			return output == "0";
-		#elif JUCE_WINDOWS
-			// Get authority information
-			SID_IDENTIFIER_AUTHORITY	NtAuthority = SECURITY_NT_AUTHORITY;
-			PSID						AdministratorsGroup;
-
-			if ( AllocateAndInitializeSid ( &NtAuthority, 2, SECURITY_BUILTIN_DOMAIN_RID, DOMAIN_ALIAS_RID_ADMINS, 0, 0, 0, 0, 0, 0, &AdministratorsGroup ) )
-			{
-				BOOL	isMember = false;
+		const auto	size = juce::jmax ( juce::int64 ( 1 ), entry.size );
 
-				CheckTokenMembership ( nullptr, AdministratorsGroup, &isMember );
+		if ( auto in = openLogFile ( entry.file ) )
+		{
+			// Compressed streams do not know their length, they only report progress per file
+			const auto	length = in->getTotalLength ();
 
-				FreeSid ( AdministratorsGroup );
+			const auto	ok = BinaryLogFormat::copyAsText ( *in, out, [ & ]
+			{
+				const auto	fraction = length > 0 ? double ( in->getPosition () ) / double ( length ) : 0.0;
+				return keepGoing ( ( double ( done ) + fraction * double ( size ) ) / double ( total ) );
+			} );
+
+			if ( ! ok )
+				return false;
+		}
+		else if ( ! out.writeText ( getUnreadableFileNote ( entry.file ), false, false, nullptr ) )
+		{
+			return false;
+		}
 
-				return isMember;
-			}
+		if ( ! out.writeText ( "------------------------------------------------------------------------------\r\n\r\n", false, false, nullptr ) )
 			return false;
-		#else
-			#error "Unknown platform!"
-		#endif
-	};
-
-	text += "Computer:  " + juce::SystemStats::getComputerName () + "\r\n";
-	text += "OS:        " + juce::SystemStats::getOperatingSystemName () + "\r\n";
-	text += "Device:    " + ( juce::SystemStats::getDeviceManufacturer () + " " + juce::SystemStats::getDeviceDescription () ).trim () + "\r\n";
-	text += "Admin:     " + juce::String ( isCurrentUserAdmin () ? "Yes" : "No" ) + "\r\n\r\n";
-
-	//
-	// CPU specific
-	//
-	text += "CPU:       " + juce::SystemStats::getCpuVendor () + " " + juce::SystemStats::getCpuModel () + " " + juce::String ( juce::SystemStats::getCpuSpeedInMegahertz () ) + " MHz\r\n";
-	text += "Cores:     " + juce::String ( juce::SystemStats::getNumPhysicalCpus () ) + " / " + juce::String ( juce::SystemStats::getNumCpus () ) + "\r\n";
-	text += "Memory:    " + juce::String ( juce::roundToInt ( juce::SystemStats::getMemorySizeInMegabytes () / 1024.0 ) ) + " GB" + "\r\n";
-
-	//
-	// Displays
-	//
-	for ( const auto& d : juce::Desktop::getInstance().getDisplays ().displays )
-	{
-		const auto	physRect = ( d.totalArea.toDouble () * d.scale ).toNearestIntEdges ();
 
-		text += juce::String::formatted ( "Display:   %d x %d @ %d%%\r\n", physRect.getWidth (), physRect.getHeight (), juce::roundToInt ( d.scale * 100.0 ) );
+		done += size;
+
+		if ( ! keepGoing ( double ( done ) / double ( total ) ) )
+			return false;
 	}
 
-	if ( additionalSystemStats )
-		text += additionalSystemStats ();
+	return true;
+}
+//-------------------------------------------------------------------------------------------------
 
-	text += "------------------------------------------------------------------------------\r\n\r\n";
+// False for mapped files and files that are gone
+static bool isPlainTextFile ( const juce::File& f )
+{
+	juce::FileInputStream	in ( f );
 
-	return text;
+	return in.openedOk () && ! MappedLogFile::readCommittedEnd ( in );
 }
 //-------------------------------------------------------------------------------------------------
 
-juce::String Logging::getAsString ()
+// Log files are named after their start time with milliseconds, "20261018T050748.123+0000.rlog.gz"
+// becomes "20261018T050748.123+0000.txt"
+static juce::String getTextEntryName ( const juce::File& f )
 {
-	auto	text = getSystemStats ();
+	auto	name = f.getFileName ();
 
-	if ( logStream != nullptr )
-		text += mergeLogFiles ();
+	if ( name.endsWithIgnoreCase ( BinaryLogFormat::compressedFileExtension ) )
+		name = name.dropLastCharacters ( int ( std::strlen ( BinaryLogFormat::compressedFileExtension ) ) );
 
-	for ( auto& msg : messages )
-		text += msg.toString () + "\r\n";
+	for ( auto extension : { BinaryLogFormat::fileExtension, ".txt" } )
+		if ( name.endsWithIgnoreCase ( extension ) )
+			return name.dropLastCharacters ( int ( std::strlen ( extension ) ) ) + ".txt";
 
-	return text;
+	return name + ".txt";
 }
 //-------------------------------------------------------------------------------------------------
 
-juce::String Logging::mergeLogFiles ()
+bool Logging::writeSupportZip ( juce::OutputStream& out, const std::function<bool ( double )>& progress )
 {
-	juce::String text;
+	auto	keepGoing = [ &progress ] ( double p ) { return ! progress || progress ( juce::jlimit ( 0.0, 1.0, p ) ); };
+
+	const auto	now = juce::Time::getCurrentTime ();
+	const auto	stats = getSystemStats ();
+
+	juce::ZipFile::Builder					zip;
+	juce::OwnedArray<juce::TemporaryFile>	converted;
 
-	auto	files = logFolder.findChildFiles ( juce::File::findFiles, false );
-	std::sort ( files.begin (), files.end (), [] ( const auto& lhs, const auto& rhs ) { return lhs.getCreationTime () < rhs.getCreationTime (); } );
+	zip.addEntry ( new juce::MemoryInputStream ( stats.toRawUTF8 (), stats.getNumBytesAsUTF8 (), true ), 9, "system.txt", now );
 
-	// Get all the files except the last (current) one
-	for ( auto i = 0; i < files.size () - 1; i++ )
+	auto&	writer = fileSink->getWriter ();
+
+	if ( writer.isOpen () )
 	{
-		auto	f = files[ i ];
+		sinks->flush ();
+
+		const auto	files = writer.getLogFiles ();
+
+		for ( size_t i = 0; i < files.size (); ++i )
+		{
+			const auto&	f = files[ i ].file;
 
-		text += f.loadFileAsString ();
-		text += "------------------------------------------------------------------------------\r\n\r\n";
+			// Text files go in as they are. Binary, compressed and mapped ones are converted to text
+			// first, which leaves out the header and unused end of mapped ones. The zip builder reads
+			// every entry when it writes, so they are converted into files.
+			if ( f.hasFileExtension ( ".txt" ) && isPlainTextFile ( f ) )
+			{
+				zip.addFile ( f, 9, f.getFileName () );
+			}
+			else if ( auto in = openLogFile ( f ) )
+			{
+				auto	temp = converted.add ( new juce::TemporaryFile ( ".txt" ) );
+
+				{
+					juce::FileOutputStream	to ( temp->getFile () );
+
+					if ( ! to.openedOk () || ! BinaryLogFormat::copyAsText ( *in, to, [ & ] { return keepGoing ( 0.5 * double ( i ) / double ( files.size () ) ); } ) )
+						return false;
+				}
+
+				zip.addFile ( temp->getFile (), 9, getTextEntryName ( f ) );
+			}
+			else
+			{
+				const auto	note = getUnreadableFileNote ( f );
+				zip.addEntry ( new juce::MemoryInputStream ( note.toRawUTF8 (), note.getNumBytesAsUTF8 (), true ), 9, getTextEntryName ( f ), now );
+			}
+
+			if ( ! keepGoing ( 0.5 * double ( i + 1 ) / double ( files.size () ) ) )
+				return false;
+		}
 	}
+	else
+	{
+		auto	text = std::make_unique<juce::MemoryOutputStream> ();
 
-	return text;
+		if ( ! writeRetainedMessages ( *text, [ &keepGoing ] ( double p ) { return keepGoing ( 0.5 * p ); } ) )
+			return false;
+
+		zip.addEntry ( new juce::MemoryInputStream ( text->getMemoryBlock (), true ), 9, "messages.txt", now );
+	}
+
+	// The builder cannot be interrupted, it compresses one entry at a time
+	return zip.writeToStream ( out, nullptr ) && keepGoing ( 1.0 );
+}
+//-------------------------------------------------------------------------------------------------
+
+bool Logging::writeRetainedMessages ( juce::OutputStream& out, const std::function<bool ( double )>& keepGoing )
+{
+	const auto	messages = getMessages ();
+
+	for ( int i = 0; i < messages.size (); ++i )
+	{
+		messages.getReference ( i ).writeTo ( out );
+
+		if ( ! out.write ( "\r\n", 2 ) )
+			return false;
+
+		if ( i % 1024 == 0 && ! keepGoing ( double ( i ) / double ( messages.size () ) ) )
+			return false;
+	}
+
+	return keepGoing ( 1.0 );
 }
 //-------------------------------------------------------------------------------------------------
 
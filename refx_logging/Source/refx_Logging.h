@@ -2,22 +2,82 @@
 
 #include <chrono>
 
-#define	Z_ERR(_m)		{ juce::String zTempDbgBuf; zTempDbgBuf << _m; ::reFX::Logging::logMessage ( zTempDbgBuf, ::reFX::LogLevel::error ); }
+// The argument expression is only evaluated if the level is enabled at runtime
+#define	Z_LOG_AT_LEVEL(_l, _m)	{ if ( ::reFX::Logging::isLevelEnabled ( _l ) ) { Z_LOG_CALL_SITE ( _l, #_m ); if ( zCallSite.hit () ) { juce::String zTempDbgBuf; zTempDbgBuf.preallocateBytes ( 128 ); zTempDbgBuf << _m; ::reFX::Logging::logMessage ( std::move ( zTempDbgBuf ), _l, &zCallSite ); } } }
 
-#define	Z_WARN(_m)		{ juce::String zTempDbgBuf; zTempDbgBuf << _m; ::reFX::Logging::logMessage ( zTempDbgBuf, ::reFX::LogLevel::warning ); }
+// Every macro expansion has one of these, see LogCallSite
+#define	Z_LOG_CALL_SITE(_l, _text)	static ::reFX::LogCallSite zCallSite { __FILE__, __LINE__, __func__, _l, _text }
 
-#define	Z_INFO(_m)		{ juce::String zTempDbgBuf; zTempDbgBuf << _m; ::reFX::Logging::logMessage ( zTempDbgBuf, ::reFX::LogLevel::info ); }
+// Category variant, Z_INFO_C ( "ui.browser", "x=" << x ). The category is looked up once per call site,
+// its level decides instead of the global one, see LogCategory.
+#define	Z_LOG_AT_CATEGORY(_c, _l, _m)	{ static ::reFX::LogCallSite zCallSite { __FILE__, __LINE__, __func__, _l, #_m, &::reFX::LogCategory::get ( _c ) }; if ( zCallSite.category->isEnabled ( _l ) && zCallSite.hit () ) { juce::String zTempDbgBuf; zTempDbgBuf.preallocateBytes ( 128 ); zTempDbgBuf << _m; ::reFX::Logging::logMessage ( std::move ( zTempDbgBuf ), _l, &zCallSite ); } }
 
-#if REFX_DEVELOPMENT || _DEBUG
-	#define Z_LOG(_m)	{ juce::String zTempDbgBuf; zTempDbgBuf << _m; ::reFX::Logging::logMessage ( zTempDbgBuf, ::reFX::LogLevel::log ); }
+// Formatted variant, Z_INFOF ( "x={} y={}", x, y ). Formats into a reused per-thread buffer instead of
+// growing a temporary string, see Logging::logFormatted.
+#define	Z_FORMAT_AT_LEVEL(_l, ...)	{ if ( ::reFX::Logging::isLevelEnabled ( _l ) ) { Z_LOG_CALL_SITE ( _l, #__VA_ARGS__ ); if ( zCallSite.hit () ) ::reFX::Logging::logFormatted ( _l, &zCallSite, __VA_ARGS__ ); } }
+
+// Rate limited variant, Z_WARN_EVERY ( 1000, "x=" << x ) logs at most once per second from this call site.
+// The message is only built when it gets through, and then tells how many were suppressed before it.
+#define	Z_LOG_EVERY_AT_LEVEL(_l, _ms, _m)	{ if ( ::reFX::Logging::isLevelEnabled ( _l ) ) { Z_LOG_CALL_SITE ( _l, #_m ); static ::reFX::LogRateLimit zRateLimit; int zSuppressed = 0; if ( zCallSite.hit () && zRateLimit.tryAcquire ( _ms, zSuppressed ) ) { juce::String zTempDbgBuf; zTempDbgBuf.preallocateBytes ( 128 ); zTempDbgBuf << _m; if ( zSuppressed > 0 ) zTempDbgBuf << " (" << zSuppressed << " suppressed)"; ::reFX::Logging::logMessage ( std::move ( zTempDbgBuf ), _l, &zCallSite ); } } }
+
+#if REFX_LOG_MIN_LEVEL <= 4
+	#define	Z_ERR(_m)	Z_LOG_AT_LEVEL ( ::reFX::LogLevel::error, _m )
+	#define	Z_ERRF(...)	Z_FORMAT_AT_LEVEL ( ::reFX::LogLevel::error, __VA_ARGS__ )
+	#define	Z_ERR_EVERY(_ms, _m)	Z_LOG_EVERY_AT_LEVEL ( ::reFX::LogLevel::error, _ms, _m )
+	#define	Z_ERR_C(_c, _m)	Z_LOG_AT_CATEGORY ( _c, ::reFX::LogLevel::error, _m )
+#else
+	#define Z_ERR(_m)
+	#define Z_ERRF(...)
+	#define Z_ERR_EVERY(_ms, _m)
+	#define Z_ERR_C(_c, _m)
+#endif
+
+#if REFX_LOG_MIN_LEVEL <= 3
+	#define	Z_WARN(_m)	Z_LOG_AT_LEVEL ( ::reFX::LogLevel::warning, _m )
+	#define	Z_WARNF(...)	Z_FORMAT_AT_LEVEL ( ::reFX::LogLevel::warning, __VA_ARGS__ )
+	#define	Z_WARN_EVERY(_ms, _m)	Z_LOG_EVERY_AT_LEVEL ( ::reFX::LogLevel::warning, _ms, _m )
+	#define	Z_WARN_C(_c, _m)	Z_LOG_AT_CATEGORY ( _c, ::reFX::LogLevel::warning, _m )
+#else
+	#define Z_WARN(_m)
+	#define Z_WARNF(...)
+	#define Z_WARN_EVERY(_ms, _m)
+	#define Z_WARN_C(_c, _m)
+#endif
+
+#if REFX_LOG_MIN_LEVEL <= 2
+	#define	Z_INFO(_m)	Z_LOG_AT_LEVEL ( ::reFX::LogLevel::info, _m )
+	#define	Z_INFOF(...)	Z_FORMAT_AT_LEVEL ( ::reFX::LogLevel::info, __VA_ARGS__ )
+	#define	Z_INFO_EVERY(_ms, _m)	Z_LOG_EVERY_AT_LEVEL ( ::reFX::LogLevel::info, _ms, _m )
+	#define	Z_INFO_C(_c, _m)	Z_LOG_AT_CATEGORY ( _c, ::reFX::LogLevel::info, _m )
+#else
+	#define Z_INFO(_m)
+	#define Z_INFOF(...)
+	#define Z_INFO_EVERY(_ms, _m)
+	#define Z_INFO_C(_c, _m)
+#endif
+
+#if ( REFX_DEVELOPMENT || _DEBUG ) && REFX_LOG_MIN_LEVEL <= 1
+	#define Z_LOG(_m)	Z_LOG_AT_LEVEL ( ::reFX::LogLevel::log, _m )
+	#define Z_LOGF(...)	Z_FORMAT_AT_LEVEL ( ::reFX::LogLevel::log, __VA_ARGS__ )
+	#define Z_LOG_EVERY(_ms, _m)	Z_LOG_EVERY_AT_LEVEL ( ::reFX::LogLevel::log, _ms, _m )
+	#define Z_LOG_C(_c, _m)	Z_LOG_AT_CATEGORY ( _c, ::reFX::LogLevel::log, _m )
 #else
 	#define Z_LOG(_m)
+	#define Z_LOGF(...)
+	#define Z_LOG_EVERY(_ms, _m)
+	#define Z_LOG_C(_c, _m)
 #endif
 
-#ifdef _DEBUG
-	#define Z_DLOG(_m)	{ juce::String zTempDbgBuf; zTempDbgBuf << _m; ::reFX::Logging::logMessage ( zTempDbgBuf, ::reFX::LogLevel::debuglog ); }
+#if defined ( _DEBUG ) && REFX_LOG_MIN_LEVEL <= 0
+	#define Z_DLOG(_m)	Z_LOG_AT_LEVEL ( ::reFX::LogLevel::debuglog, _m )
+	#define Z_DLOGF(...)	Z_FORMAT_AT_LEVEL ( ::reFX::LogLevel::debuglog, __VA_ARGS__ )
+	#define Z_DLOG_EVERY(_ms, _m)	Z_LOG_EVERY_AT_LEVEL ( ::reFX::LogLevel::debuglog, _ms, _m )
+	#define Z_DLOG_C(_c, _m)	Z_LOG_AT_CATEGORY ( _c, ::reFX::LogLevel::debuglog, _m )
 #else
 	#define Z_DLOG(_m)
+	#define Z_DLOGF(...)
+	#define Z_DLOG_EVERY(_ms, _m)
+	#define Z_DLOG_C(_c, _m)
 #endif
 
 namespace reFX
@@ -25,6 +85,16 @@ namespace reFX
 //-------------------------------------------------------------------------------------------------
 
 class LoggingWindow;
+class LogWriter;
+class LogHistory;
+class LogRowCache;
+class LogSink;
+class LogSinkDispatcher;
+class LogSystemInfo;
+class LogCategory;
+class FileLogSink;
+struct LogStats;
+struct RealtimeLogEntry;
 
 enum class LogLevel : int
 {
@@ -47,6 +117,153 @@ struct LoggingOptions
 #endif
 
 	std::function<std::unique_ptr<juce::LookAndFeel>()>	lookAndFeelFactory;
+
+	bool		saveAsZip = false;		// The save button writes a zip instead of one text file
+};
+//-------------------------------------------------------------------------------------------------
+
+enum class LogFileFormat
+{
+	text,			// Human readable, one formatted line per message
+	binary,			// Compact records, formatted only when read, see BinaryLogFormat
+};
+//-------------------------------------------------------------------------------------------------
+
+struct LogWriterOptions
+{
+	LogFileFormat	format = LogFileFormat::text;		// Applies to log files opened afterwards
+	bool			asynchronous = false;				// Hand messages to a background thread instead of writing on the caller's thread
+	int				flushEveryMessages = 1;				// Flush after this many messages, 0 to disable
+	int				flushIntervalMs = 0;				// Flush when the last flush is older than this, 0 to disable
+	bool			flushImmediatelyOnError = true;		// Always flush after a LogLevel::error message
+
+	juce::int64		maxFileBytes = 0;					// Start a new file when the current one reaches this size, 0 to disable
+	int				rotationIntervalSeconds = 0;		// Start a new file when the current one is this old, 0 to disable
+	int				maxFiles = 4;						// Log files kept in the folder including the current one, 0 for no limit
+	juce::int64		maxTotalBytes = 0;					// Total size of the log files kept in the folder, 0 for no limit
+	bool			compressOldFiles = false;			// Gzip files this writer rotated in the background
+	bool			writeSystemInfo = true;				// Start each log file with the machine details, see LogSystemInfo
+	bool			memoryMapped = false;				// Write through a memory mapping that survives a crash without flushing, see MappedLogFile
+};
+//-------------------------------------------------------------------------------------------------
+
+enum class LogOverflowPolicy
+{
+	dropNewest,		// Discard the message that does not fit
+	dropOldest,		// Discard the oldest queued message to make room
+	block,			// Wait until the consumer made room, messages logged by sinks during delivery are dropped
+};
+//-------------------------------------------------------------------------------------------------
+
+// Wall-clock time in nanoseconds since the Unix epoch. Reads the monotonic clock, which needs no
+// syscall on the common platforms, and adds an offset to the system clock that is measured once
+// and refreshed by recalibrate (). A recalibration can step the time, so durations are measured
+// with steadyNow () instead.
+class LogClock
+{
+public:
+	static juce::int64 now () noexcept							{ return toWallTime ( steadyNanos () ); }
+	static void recalibrate () noexcept							{ offset () = systemNanos () - steadyNanos (); }
+
+	// Monotonic nanoseconds, only differences of them mean anything
+	static juce::int64 steadyNow () noexcept					{ return steadyNanos (); }
+	static juce::int64 toWallTime ( juce::int64 steadyNs ) noexcept	{ return steadyNs + offset ().load ( std::memory_order_relaxed ); }
+
+private:
+	static juce::int64 steadyNanos () noexcept
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds> ( std::chrono::steady_clock::now ().time_since_epoch () ).count ();
+	}
+
+	static juce::int64 systemNanos () noexcept
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds> ( std::chrono::system_clock::now ().time_since_epoch () ).count ();
+	}
+
+	static std::atomic<juce::int64>& offset () noexcept
+	{
+		static std::atomic<juce::int64>	o { systemNanos () - steadyNanos () };
+		return o;
+	}
+};
+//-------------------------------------------------------------------------------------------------
+
+// Lets one message per interval through for a call site, see Z_WARN_EVERY. Counts the messages
+// it suppressed in between.
+class LogRateLimit
+{
+public:
+	// Returns true if the call site may log now, suppressed gets the number dropped since the last one
+	bool tryAcquire ( int intervalMs, int& suppressed ) noexcept
+	{
+		const auto	now = LogClock::now ();
+		auto		due = nextDue.load ( std::memory_order_relaxed );
+
+		if ( now < due || ! nextDue.compare_exchange_strong ( due, now + juce::int64 ( intervalMs ) * 1000000, std::memory_order_relaxed ) )
+		{
+			numSuppressed.fetch_add ( 1, std::memory_order_relaxed );
+			return false;
+		}
+
+		suppressed = numSuppressed.exchange ( 0, std::memory_order_relaxed );
+
+		// Counted late, but only once per message that gets through
+		if ( suppressed > 0 )
+			totalSuppressed.fetch_add ( suppressed, std::memory_order_relaxed );
+
+		return true;
+	}
+
+	// All call sites, see LogStats::rateLimited
+	static inline std::atomic<juce::int64>	totalSuppressed { 0 };
+
+private:
+	std::atomic<juce::int64>	nextDue { 0 };
+	std::atomic<int>			numSuppressed { 0 };
+};
+//-------------------------------------------------------------------------------------------------
+
+// Where messages are logged from. Each Z_* macro expansion has a static instance, which adds itself
+// to a global list the first time it is reached. Messages point to it, so they carry file, line
+// and function without copying them. Sites can be switched off at runtime and count their hits.
+struct LogCallSite
+{
+	constexpr LogCallSite ( const char* f, int l, const char* fn, LogLevel lv, const char* t, LogCategory* c = nullptr ) noexcept
+		: file ( f ), line ( l ), function ( fn ), level ( lv ), text ( t ), category ( c ) {}
+
+	// Counts the hit and registers the site on first use. Returns false if the site is disabled.
+	bool hit () noexcept
+	{
+		if ( ! registered.load ( std::memory_order_acquire ) )
+			registerSite ();
+
+		hits.fetch_add ( 1, std::memory_order_relaxed );
+		return enabled.load ( std::memory_order_relaxed );
+	}
+
+	juce::String getFileName () const;		// Without the path
+
+	// The category's level if the site has one, otherwise the global level
+	bool isLevelEnabled ( LogLevel ) const noexcept;
+
+	// Every site reached so far, in no particular order
+	static std::vector<LogCallSite*> getAll ();
+
+	const char*					file;
+	int							line;
+	const char*					function;
+	LogLevel					level;
+	const char*					text;			// The message expression or format arguments as written
+	LogCategory*				category;		// Null for the macros without a category
+
+	std::atomic<bool>			enabled { true };
+	std::atomic<juce::int64>	hits { 0 };		// Counted while the level is enabled, also when the site is not
+
+private:
+	void registerSite () noexcept;
+
+	std::atomic<bool>			registered { false };
+	LogCallSite*				next = nullptr;
 };
 //-------------------------------------------------------------------------------------------------
 
@@ -54,12 +271,24 @@ struct LogMessage
 {
 	LogMessage ( const juce::String& d = "", const LogLevel l = LogLevel::debuglog )
 		: description ( d ), level ( l ) {}
-
-	juce::String toString ();
-
-	const time_t		timeStamp = std::chrono::system_clock::to_time_t (std::chrono::system_clock::now ());
-	const juce::String	description;
-	const LogLevel 		level = LogLevel::debuglog;
+	LogMessage ( juce::String&& d, const LogLevel l )
+		: description ( std::move ( d ) ), level ( l ) {}
+
+	juce::String toString () const;
+	void writeTo ( juce::OutputStream& ) const;	// Same as toString, without building a string
+	juce::String getTimeString () const;		// Local time with microseconds, HH:MM:SS.uuuuuu
+	juce::String getThreadString () const;		// Thread name, or its id if it has none
+
+	// Name of the calling juce::Thread or the message thread, looked up once per thread
+	static juce::String getCurrentThreadName ();
+
+	juce::int64		timeNs = LogClock::now ();
+	juce::String	description;
+	LogLevel 		level = LogLevel::debuglog;
+	juce::uint64	sequence = 0;			// Global order in which messages entered the queue, starts at 1
+	juce::uint64	threadId = juce::uint64 ( juce::pointer_sized_int ( juce::Thread::getCurrentThreadId () ) );
+	juce::String	threadName = getCurrentThreadName ();
+	LogCallSite*	site = nullptr;		// Null for messages that did not come from a Z_* macro
 };
 //-------------------------------------------------------------------------------------------------
 
@@ -67,9 +296,10 @@ class Logging
 	: public juce::AsyncUpdater
 	, public juce::DeletedAtShutdown
 	, public juce::Logger
+	, private juce::Timer
 {
 public:
-	Logging () = default;
+	Logging ();
 	~Logging () override;
 
 	juce::String					creatorString;
@@ -77,8 +307,28 @@ public:
 
 	void setLogFolder ( const juce::File& );
 
-	LogLevel getLogLevel ()				{ return level; }
-	void setLogLevel ( LogLevel l )		{ level = l;	}
+	void setWriterOptions ( const LogWriterOptions& );
+	LogWriterOptions getWriterOptions ();
+
+	void setOverflowPolicy ( LogOverflowPolicy p )	{ overflowPolicy = p; }
+	LogOverflowPolicy getOverflowPolicy ()			{ return overflowPolicy; }
+	juce::int64 getNumDroppedMessages ()			{ return droppedMessages; }
+
+	// Identical consecutive messages are delivered once, followed by "Last message repeated N times"
+	// when a different message arrives or at least once a second. On by default.
+	void setCollapseRepeats ( bool b )				{ collapseRepeats = b; }
+	bool getCollapseRepeats ()						{ return collapseRepeats; }
+
+	// The in-memory history only keeps the newest messages, the log file has all of them
+	void setHistoryCapacity ( int numMessages );
+	int getHistoryCapacity ();
+	juce::uint64 getOldestRetainedSequence ();
+
+	LogLevel getLogLevel ()				{ return LogLevel ( activeLevel.load () ); }
+	void setLogLevel ( LogLevel l );
+
+	// Only an atomic load, cheap enough to be checked before a message is even built
+	static bool isLevelEnabled ( LogLevel l )	{ return int ( l ) >= activeLevel.load ( std::memory_order_relaxed ); }
 
 	static juce::String getLogLevelName ( LogLevel l );
 
@@ -86,16 +336,66 @@ public:
 	LoggingWindow& getLoggingWindow ( const LoggingOptions& );
 	bool isLoggingWindowVisible ();
 
-	static void logMessage ( const juce::String& message, const LogLevel level );
+	// Rendered rows shared by the logging views, message thread only
+	LogRowCache& getRowCache ();
+
+	static void logMessage ( const juce::String& message, const LogLevel level, LogCallSite* site = nullptr );
+	static void logMessage ( juce::String&& message, const LogLevel level, LogCallSite* site = nullptr );
+
+	// Replaces each {} in format with the next argument, see Z_INFOF. Arguments can be numbers,
+	// bools, enums, pointers and strings.
+	template <typename... Args>
+	static void logFormatted ( LogLevel level, LogCallSite* site, const char* format, const Args&... args );
+
+	// Real-time safe, see Z_RT_INFO
+	template <typename... Args>
+	static void logRealtime ( LogLevel level, LogCallSite* site, const char* format, const Args&... args );
+
+	juce::int64 getNumDroppedRealtimeMessages ()	{ return droppedRealtimeMessages; }
+
+	// Counters and latencies of the logging itself, cheap enough to be always on. Part of the
+	// support report and shown in the logging window.
+	LogStats getStats ();
+
+	// Outputs for delivered messages. Registered by default are the log file, the listeners and,
+	// with REFX_LOG_DEBUG_OUTPUT, the debugger output.
+	void addSink ( std::shared_ptr<LogSink> );
+	void removeSink ( const std::shared_ptr<LogSink>& );
+
+	std::shared_ptr<FileLogSink> getFileSink ()			{ return fileSink; }
+	std::shared_ptr<LogSink> getDebugOutputSink ()		{ return debugOutputSink; }
+
+	// Machine details for the support report, cached so sinks can read them without delay
+	LogSystemInfo& getSystemInfo ()						{ return *systemInfo; }
+
+	// Records the Z_TRACE_* events into the Traces folder next to the log files, see LogTrace.
+	// Returns false without a log folder or if the trace file cannot be created.
+	bool startTrace ();
+	void stopTrace ();
 
 	juce::String getAsString ();
 
+	// Streams the support report (system stats and all log files, or the retained messages if there
+	// is no log file) without building it in memory. progress gets 0...1 and can return false to
+	// cancel. Returns false if cancelled or writing failed. Can be called from any thread.
+	bool writeSupportInfo ( juce::OutputStream&, const std::function<bool ( double progress )>& = {} );
+
+	// Same content as a zip, one text entry for the system stats and one per log file
+	bool writeSupportZip ( juce::OutputStream&, const std::function<bool ( double progress )>& = {} );
+
 	class Listener
 	{
 	public:
 		virtual ~Listener () = default;
 
 		virtual void messageLogged ( const LogMessage& ) {}
+
+		// Called on the message thread with everything logged since the last call
+		virtual void messagesLogged ( const juce::Array<LogMessage>& batch )
+		{
+			for ( const auto& msg : batch )
+				messageLogged ( msg );
+		}
 	};
 
 	void addListener ( Listener* l );
@@ -106,6 +406,9 @@ public:
 
 private:
 	friend class LoggingWindow;
+	friend class ListenerLogSink;
+	friend class LogSearch;
+	friend class LogCategory;
 
 	void logMessage ( const juce::String& message ) override
 	{
@@ -114,20 +417,70 @@ private:
 
 	juce::Array<LogMessage> getMessages ();
 
+	// Appends the retained messages newer than the given sequence number and returns the newest
+	// sequence number delivered so far
+	juce::uint64 getMessagesSince ( juce::uint64 sequence, juce::Array<LogMessage>& dest );
+
 	void handleAsyncUpdate () override;
 
+	void timerCallback () override;
+
+	void enqueue ( LogMessage&& );
+	void deliverQueuedMessages ();
+	void drainRealtimeQueue ();
+	bool collapseRepeat ( LogMessage& );
+	void addRepeatSummary ();
+	void queueForListeners ( const LogMessage* messages, int numMessages );
+	void noteQueueDepth ( int numQueued );
+
 	juce::String getSystemStats ();
-	juce::String mergeLogFiles ();
+	bool writeRetainedMessages ( juce::OutputStream&, const std::function<bool ( double )>& keepGoing );
+
+	LogQueue<LogMessage>			queue { REFX_LOG_QUEUE_SIZE };
+	std::atomic<LogOverflowPolicy>	overflowPolicy { LogOverflowPolicy::dropNewest };
+	std::atomic<juce::int64>		droppedMessages { 0 };
+
+	std::unique_ptr<LogQueue<RealtimeLogEntry>>	realtimeQueue;
+	std::atomic<juce::int64>					droppedRealtimeMessages { 0 };
+	juce::SpinLock								realtimeDrainLock;
+	int											timerTicks = 0;
+
+	juce::SpinLock				deliveryLock;
+	std::vector<LogMessage>		deliveryBatch;
+	juce::uint64				lastSequence = 0;
+
+	// Repeat collapsing, guarded by the delivery lock like the batch
+	static constexpr juce::int64	repeatSummaryNs = 1000000000;
+	std::atomic<bool>			collapseRepeats { true };
+	juce::String				lastDeliveredText;
+	LogLevel					lastDeliveredLevel = LogLevel::debuglog;
+	LogMessage					lastRepeat;				// Newest message collapsed into the last delivered one
+	int							numRepeats = 0;
+	juce::int64					repeatStartNs = 0;
 
 	juce::CriticalSection 	lock;
-	juce::Array<LogMessage>	messages;
-	LogLevel				level = LogLevel::debuglog;
-
-	juce::File								logFolder;
-	std::unique_ptr<juce::FileOutputStream>	logStream;
+	std::unique_ptr<LogHistory>	history;
+
+	static inline std::atomic<int>	activeLevel { int ( LogLevel::debuglog ) };
+
+	// Self-instrumentation, see getStats
+	std::array<std::atomic<juce::int64>, 5>	loggedMessages {};
+	std::atomic<juce::int64>				repeatsCollapsed { 0 };
+	std::atomic<int>						queueHighWater { 0 };
+	LogLatencyHistogram						deliveryTime;
+	LogLatencyHistogram						blockedTime;
+	static inline std::atomic<juce::int64>	filteredMessages { 0 };
+
+	std::shared_ptr<LogSystemInfo>			systemInfo;			// Shared with the log writer
+	std::unique_ptr<LogSinkDispatcher>		sinks;
+	std::shared_ptr<FileLogSink>			fileSink;
+	std::shared_ptr<LogSink>				debugOutputSink;
 	std::unique_ptr<LoggingWindow> 			loggingWindow;
+	std::unique_ptr<LogRowCache>			rowCache;
 
 	juce::ListenerList<Listener>			listeners;
+	juce::CriticalSection					listenerQueueLock;
+	std::vector<LogMessage>					listenerQueue;
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR ( Logging )
 };
@@ -1,5 +1,3 @@
-#include <ctime>
-
 #include "refx_LoggingComponent.h"
 
 namespace reFX {
@@ -44,24 +42,18 @@ juce::String LoggingComponent::getNameForRow ( int row )
 {
 	if ( juce::isPositiveAndBelow ( row, messages.size () ) )
 	{
-		const auto message = messages[ row ];
-
-		// Compose final message
-		char dstTime[ 100 ] = { 0 };
-		std::strftime ( dstTime, sizeof ( dstTime ), "%T", std::localtime ( &message.timeStamp ) );
-
-		return juce::String ( dstTime ) + " - " + message.description;
+		return LogRowCache::formatRow ( messages.getReference ( row ) );
 	}
 
 	return {};
 }
 //-------------------------------------------------------------------------------------------------
 
-void LoggingComponent::paintListBoxItem ( int row, juce::Graphics& g, int width, int height, bool /*rowIsSelected*/ )
+void LoggingComponent::paintListBoxItem ( int row, juce::Graphics& g, int /*width*/, int height, bool /*rowIsSelected*/ )
 {
 	if ( juce::isPositiveAndBelow ( row, messages.size () ) )
 	{
-		const auto message = messages[ row ];
+		const auto&	message = messages.getReference ( row );
 
 		static juce::Colour	levels[][ 2 ] = {
 			{	juce::Colour ( 0xff'EBFD5A ),		juce::Colours::black	},	// dlog
@@ -71,38 +63,33 @@ void LoggingComponent::paintListBoxItem ( int row, juce::Graphics& g, int width,
 			{	juce::Colour ( 0xff'FC5454 ),		juce::Colours::black	},	// err
 		};
 
-		// Compose final message
-		char dstTime[ 100 ] = { 0 };
-		std::strftime ( dstTime, sizeof ( dstTime ), "%T", std::localtime ( &message.timeStamp ) );
-
-		const auto	text = juce::String ( dstTime ) + " - " + message.description;
-
-		g.setFont ( juce::FontOptions () );
+		const auto&	cached = Logging::getInstance ()->getRowCache ().getRow ( message, font, g.getInternalContext ().getPhysicalPixelScaleFactor () );
 
 		const auto	msgLevel = int ( message.level );
 		if ( const auto bckCol = levels[ msgLevel ][ 0 ]; ! bckCol.isTransparent () )
 		{
-			const auto	textWidth = juce::GlyphArrangement::getStringWidth ( g.getCurrentFont (), text );
-
 			g.setColour ( bckCol );
-			g.fillRoundedRectangle ( juce::Rectangle<float>{ textWidth + 8.0f, float ( dbc.getRowHeight () ) }.reduced ( 0.0f, 1.5f ), 3.0f );
+			g.fillRoundedRectangle ( juce::Rectangle<float>{ cached.width + 8.0f, float ( dbc.getRowHeight () ) }.reduced ( 0.0f, 1.5f ), 3.0f );
 		}
 
 		g.setColour ( levels[ msgLevel ][ 1 ] );
 
-		g.drawText ( text,
-					 juce::Rectangle<int> ( width, height ).reduced ( 4, 0 ),
-					 juce::Justification::centredLeft,
-					 true );
+		// Glyphs outside the row are clipped by the list box
+		LogRowCache::drawRow ( g, cached, font, 4.0f, height );
 	}
 }
 //-------------------------------------------------------------------------------------------------
 
-void LoggingComponent::messageLogged ( const LogMessage& msg )
+void LoggingComponent::messagesLogged ( const juce::Array<LogMessage>& batch )
 {
-	if ( msg.level >= LogLevel::info )
+	const auto	numBefore = messages.size ();
+
+	for ( const auto& msg : batch )
+		if ( msg.level >= LogLevel::info )
+			messages.add ( msg );
+
+	if ( messages.size () != numBefore )
 	{
-		messages.add ( msg );
 		dbc.updateContent ();
 		dbc.setVerticalPosition ( 1.0f );
 	}
@@ -17,11 +17,16 @@ public:
 	void resized () override;
 	juce::String getNameForRow ( int row ) override;
 
-	void messageLogged ( const LogMessage& ) override;
+	void messagesLogged ( const juce::Array<LogMessage>& ) override;
 
 private:
 	juce::Array<LogMessage>	messages;
 	juce::ListBox			dbc;
+#if JUCE_MAJOR_VERSION >= 8
+	juce::Font				font = juce::FontOptions ();
+#else
+	juce::Font				font = {};
+#endif
 };
 
 }
@@ -0,0 +1,577 @@
+#if JUCE_UNIT_TESTS
+
+#include <algorithm>
+#include <thread>
+
+#include "refx_LogSearch.h"
+#include "refx_LogSinks.h"
+#include "refx_BinaryLogFormat.h"
+#include "refx_MappedLogFile.h"
+
+//-------------------------------------------------------------------------------------------------
+
+
+namespace reFX
+{
+
+// The tests run against the Logging singleton. This puts back what they change.
+class ScopedLoggingState
+{
+public:
+	explicit ScopedLoggingState ( Logging& l )
+		: logging ( l )
+		, level ( l.getLogLevel () )
+		, policy ( l.getOverflowPolicy () )
+		, historyCapacity ( l.getHistoryCapacity () )
+		, writerOptions ( l.getWriterOptions () )
+		, folder ( l.getFileSink ()->getWriter ().getFolder () )
+		, debugOutput ( l.getDebugOutputSink () )
+	{
+		// Writing every message to the debugger would dominate everything else
+		if ( debugOutput != nullptr )
+			logging.removeSink ( debugOutput );
+	}
+
+	~ScopedLoggingState ()
+	{
+		logging.setWriterOptions ( writerOptions );
+		logging.setLogFolder ( folder );
+		logging.setHistoryCapacity ( historyCapacity );
+		logging.setOverflowPolicy ( policy );
+		logging.setLogLevel ( level );
+
+		if ( debugOutput != nullptr )
+			logging.addSink ( debugOutput );
+	}
+
+private:
+	Logging&					logging;
+	LogLevel					level;
+	LogOverflowPolicy			policy;
+	int							historyCapacity;
+	LogWriterOptions			writerOptions;
+	juce::File					folder;
+	std::shared_ptr<LogSink>	debugOutput;
+};
+//-------------------------------------------------------------------------------------------------
+
+// Logs from inside its delivery, like a sink that reports its own errors
+class ReentrantLoggingSink
+	: public LogSink
+{
+public:
+	explicit ReentrantLoggingSink ( int n )
+		: numToLog ( n ) {}
+
+protected:
+	void write ( const LogMessage* messages, int numMessages ) override
+	{
+		for ( int i = 0; i < numMessages; ++i )
+			if ( messages[ i ].description == "reentrant start" )
+				for ( int n = 0; n < numToLog; ++n )
+					Logging::logMessage ( "reentrant " + juce::String ( n ), LogLevel::info );
+	}
+
+private:
+	int		numToLog;
+};
+//-------------------------------------------------------------------------------------------------
+
+class LoggingTests
+	: public juce::UnitTest
+{
+public:
+	LoggingTests ()
+		: juce::UnitTest ( "reFX logging", "reFX" ) {}
+
+	void runTest () override
+	{
+		beginTest ( "Sink logs into a full blocking queue" );
+		{
+			auto&				logging = *Logging::getInstance ();
+			ScopedLoggingState	state ( logging );
+
+			logging.setLogFolder ( {} );
+			logging.setOverflowPolicy ( LogOverflowPolicy::block );
+			logging.setLogLevel ( LogLevel::debuglog );
+
+			// Only the delivering thread could make room, waiting for it would never end
+			const auto	overflow = 100;
+			auto		sink = std::make_shared<ReentrantLoggingSink> ( logging.getStats ().queueCapacity + overflow );
+			const auto	droppedBefore = logging.getNumDroppedMessages ();
+
+			logging.addSink ( sink );
+			Logging::logMessage ( "reentrant start", LogLevel::info );
+			logging.removeSink ( sink );
+
+			expect ( logging.getNumDroppedMessages () - droppedBefore >= overflow, "Messages logged during delivery were not dropped" );
+		}
+
+		beginTest ( "Damaged binary log file" );
+		{
+			juce::MemoryOutputStream	file;
+			BinaryLogFormat::writeFileHeader ( file );
+
+			for ( int n = 0; n < 100; ++n )
+				BinaryLogFormat::writeRecord ( file, LogMessage ( "record " + juce::String ( n ), LogLevel::info ) );
+
+			// Damages one record in the middle
+			auto	data = file.getMemoryBlock ();
+			data[ int ( data.getSize () / 2 ) ] ^= 0x55;
+
+			juce::MemoryInputStream	in ( data, false );
+			const auto				lines = juce::StringArray::fromLines ( BinaryLogFormat::readAsText ( in ).trimEnd () );
+
+			expectEquals ( lines.size (), 99, "Records around the damage" );
+			expect ( lines[ lines.size () - 1 ].endsWith ( "record 99" ), "Reading stopped at the damage" );
+
+			// A version from the future is not read as if it were known
+			data[ 8 ] = 99;
+
+			juce::MemoryInputStream	newer ( data, false );
+			expect ( BinaryLogFormat::readAsText ( newer ).startsWith ( "Unsupported binary log file version 99" ), "Unknown version accepted" );
+		}
+
+		beginTest ( "Memory-mapped file after a crash" );
+		runMappedRecovery ();
+
+		beginTest ( "Trace pool buffers of exited threads" );
+		{
+			auto	folder = juce::File::getSpecialLocation ( juce::File::tempDirectory ).getNonexistentChildFile ( "refx_logging_trace", {}, false );
+
+			// Together more short-lived threads than the pool holds, each trace has a fresh pool
+			for ( int trace = 0; trace < 3; ++trace )
+			{
+				expect ( LogTrace::start ( folder ), "Cannot start a trace" );
+
+				const auto	droppedBefore = LogTrace::getNumDroppedEvents ();
+
+				for ( int i = 0; i < 4; ++i )
+					std::thread ( [] { Z_TRACE_INSTANT ( "pooled" ); } ).join ();
+
+				expectEquals ( LogTrace::getNumDroppedEvents () - droppedBefore, juce::int64 ( 0 ), "Events of unregistered threads dropped" );
+
+				LogTrace::stop ();
+			}
+
+			folder.deleteRecursively ();
+		}
+	}
+
+private:
+	// A copy of a file that is still open looks like one a crashed process left behind
+	void runMappedRecovery ()
+	{
+		auto	folder = juce::File::getSpecialLocation ( juce::File::tempDirectory ).getNonexistentChildFile ( "refx_logging_mapped", {}, false );
+		folder.createDirectory ();
+
+		const auto	crashed = folder.getChildFile ( "crashed.txt" );
+
+		{
+			MappedLogFile	file ( folder.getChildFile ( "open.txt" ) );
+			expect ( file.openedOk (), "Cannot create a mapped log file" );
+
+			// Across a segment boundary, the last line is written but not committed
+			const juce::String	line ( "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcd\r\n" );
+			const auto			numLines = int ( MappedLogFile::segmentSize / line.length () ) + 100;
+
+			for ( int i = 0; i < numLines; ++i )
+			{
+				file.write ( line.toRawUTF8 (), size_t ( line.length () ) );
+				file.commit ();
+			}
+
+			file.write ( "torn", 4 );
+
+			expect ( file.getFile ().copyFileTo ( crashed ), "Cannot copy the open file" );
+
+			const auto	committedSize = juce::int64 ( MappedLogFile::headerSize ) + juce::int64 ( numLines ) * line.length ();
+
+			expect ( crashed.getSize () > committedSize, "The copy has no unused space" );
+			expectEquals ( MappedLogFile::recover ( crashed ), committedSize, "Recovered size" );
+			expectEquals ( crashed.getSize (), committedSize, "Size after recovery" );
+
+			auto	in = BinaryLogFormat::openFile ( crashed );
+			expect ( in != nullptr && in->getTotalLength () == committedSize - MappedLogFile::headerSize, "Readers skip the header" );
+		}
+
+		expectEquals ( folder.getChildFile ( "open.txt" ).getSize (), crashed.getSize () + 4, "Size after closing" );
+
+		folder.deleteRecursively ();
+	}
+};
+
+static LoggingTests	loggingTests;
+//-------------------------------------------------------------------------------------------------
+
+#if REFX_LOG_STRESS_TESTS
+
+// Checks that the messages of each producer arrive complete and in order. Producers log
+// "stress <producer> <number>" with numbers counting up from 0.
+struct StressOrderCheck
+{
+	explicit StressOrderCheck ( int numProducers )
+		: next ( size_t ( numProducers ), 0 ) {}
+
+	void add ( const juce::String& description )
+	{
+		if ( ! description.startsWith ( "stress " ) )
+			return;
+
+		const auto	rest = description.substring ( 7 );
+		const auto	producer = rest.getIntValue ();
+		const auto	number = rest.fromFirstOccurrenceOf ( " ", false, false ).getIntValue ();
+
+		if ( ! juce::isPositiveAndBelow ( producer, int ( next.size () ) ) )
+			return;
+
+		if ( number != next[ size_t ( producer ) ] )
+			++outOfOrder;
+
+		next[ size_t ( producer ) ] = number + 1;
+		++received;
+	}
+
+	std::vector<int>	next;
+	int					received = 0;
+	int					outOfOrder = 0;
+};
+//-------------------------------------------------------------------------------------------------
+
+class StressCheckingSink
+	: public LogSink
+{
+public:
+	explicit StressCheckingSink ( int numProducers )
+		: order ( numProducers ) {}
+
+	StressOrderCheck	order;
+	int					sequenceGaps = 0;
+
+protected:
+	void write ( const LogMessage* messages, int numMessages ) override
+	{
+		for ( int i = 0; i < numMessages; ++i )
+		{
+			// Every delivered message reaches the sink, so the sequence numbers have no holes
+			if ( lastSequence != 0 && messages[ i ].sequence != lastSequence + 1 )
+				++sequenceGaps;
+
+			lastSequence = messages[ i ].sequence;
+			order.add ( messages[ i ].description );
+		}
+	}
+
+private:
+	juce::uint64	lastSequence = 0;
+};
+//-------------------------------------------------------------------------------------------------
+// Many producers log while the files rotate and a search follows the log like the logging window.
+// Nothing may be lost or reordered on the way to the sinks, the window and the files.
+
+class LoggingStressTest
+	: public juce::UnitTest
+{
+public:
+	LoggingStressTest ()
+		: juce::UnitTest ( "reFX logging stress", "reFX" ) {}
+
+	void runTest () override
+	{
+		beginTest ( "Text files, asynchronous writer" );
+		runStress ( LogFileFormat::text, true, false );
+
+		beginTest ( "Binary files, synchronous writer" );
+		runStress ( LogFileFormat::binary, false, false );
+
+		beginTest ( "Memory-mapped text files, synchronous writer" );
+		runStress ( LogFileFormat::text, false, true );
+
+		beginTest ( "Memory-mapped binary files, asynchronous writer" );
+		runStress ( LogFileFormat::binary, true, true );
+	}
+
+private:
+	static constexpr int	numProducers = 8;
+	static constexpr int	messagesPerProducer = 20000;
+	static constexpr int	numMessages = numProducers * messagesPerProducer;
+
+	void runStress ( LogFileFormat format, bool asynchronous, bool memoryMapped )
+	{
+		auto&	logging = *Logging::getInstance ();
+		auto	folder = juce::File::getSpecialLocation ( juce::File::tempDirectory ).getNonexistentChildFile ( "refx_logging_stress", {}, false );
+
+		{
+			ScopedLoggingState	state ( logging );
+
+			LogWriterOptions	o;
+			o.format = format;
+			o.asynchronous = asynchronous;
+			o.memoryMapped = memoryMapped;
+			o.flushEveryMessages = 0;
+			o.maxFileBytes = 256 * 1024;
+			o.maxFiles = 0;
+
+			logging.setWriterOptions ( o );
+			logging.setLogFolder ( folder );
+			logging.setOverflowPolicy ( LogOverflowPolicy::block );
+			logging.setHistoryCapacity ( numMessages + 4096 );
+			logging.setLogLevel ( LogLevel::debuglog );
+
+			const auto	droppedBefore = logging.getNumDroppedMessages ();
+			const auto	statsBefore = logging.getStats ();
+			auto		sink = std::make_shared<StressCheckingSink> ( numProducers );
+
+			logging.addSink ( sink );
+
+			LogSearch	search ( logging );
+			search.setQuery ( "stress ", false );
+
+			std::vector<std::thread>	producers;
+
+			for ( int p = 0; p < numProducers; ++p )
+			{
+				producers.emplace_back ( [ p ]
+				{
+					// All levels, errors make the writer flush
+					for ( int n = 0; n < messagesPerProducer; ++n )
+						Z_LOG_AT_LEVEL ( LogLevel ( n % 5 ), "stress " << p << " " << n );
+				} );
+			}
+
+			for ( auto& t : producers )
+				t.join ();
+
+			logging.removeSink ( sink );
+
+			expectEquals ( sink->order.received, numMessages, "Messages lost before the sinks" );
+			expectEquals ( sink->order.outOfOrder, 0, "Messages reordered before the sinks" );
+			expectEquals ( sink->sequenceGaps, 0, "Sequence numbers skipped" );
+			expectEquals ( logging.getNumDroppedMessages () - droppedBefore, juce::int64 ( 0 ), "Messages dropped" );
+
+			// The pipeline's own counters saw at least as many, other threads may log meanwhile
+			const auto	stats = logging.getStats ();
+
+			expect ( stats.getNumMessages () - statsBefore.getNumMessages () >= numMessages, "Messages missing from the stats" );
+			expect ( stats.messages[ size_t ( LogLevel::error ) ] - statsBefore.messages[ size_t ( LogLevel::error ) ] >= numMessages / 5, "Errors missing from the stats" );
+			expect ( stats.deliveryTime.count > statsBefore.deliveryTime.count, "No deliveries timed" );
+			expect ( stats.queueHighWater > 0, "No queue depth seen" );
+
+			// The window side, read from the history by the search thread
+			StressOrderCheck		found ( numProducers );
+			juce::Array<LogMessage>	results;
+			const auto				deadline = juce::Time::getMillisecondCounter () + 30000;
+
+			while ( found.received < numMessages && juce::Time::getMillisecondCounter () < deadline )
+			{
+				search.messagesAdded ();
+				juce::Thread::sleep ( 10 );
+
+				results.clearQuick ();
+				search.takeResults ( results );
+
+				for ( const auto& m : results )
+					found.add ( m.description );
+			}
+
+			expectEquals ( found.received, numMessages, "Messages missing from the search" );
+			expectEquals ( found.outOfOrder, 0, "Messages reordered in the search" );
+
+			// The file side, across all rotated files
+			auto&	writer = logging.getFileSink ()->getWriter ();
+			writer.flush ();
+
+			const auto			files = writer.getLogFiles ();
+			StressOrderCheck	written ( numProducers );
+
+			expect ( files.size () > 1, "The log files did not rotate" );
+
+			for ( const auto& entry : files )
+			{
+				auto	in = BinaryLogFormat::openFile ( entry.file );
+
+				if ( in == nullptr )
+				{
+					expect ( false, "Cannot open " + entry.file.getFileName () );
+					continue;
+				}
+
+				juce::MemoryOutputStream	text;
+				BinaryLogFormat::copyAsText ( *in, text );
+
+				for ( const auto& line : juce::StringArray::fromLines ( text.toUTF8 () ) )
+					written.add ( line.fromFirstOccurrenceOf ( "] - ", false, false ) );
+			}
+
+			expectEquals ( written.received, numMessages, "Messages missing from the log files" );
+			expectEquals ( written.outOfOrder, 0, "Messages reordered in the log files" );
+		}
+
+		folder.deleteRecursively ();
+	}
+};
+
+static LoggingStressTest	loggingStressTest;
+
+#endif
+//-------------------------------------------------------------------------------------------------
+
+#if REFX_LOG_BENCHMARKS
+
+// Allocations of the calling thread so far. The module leaves the global operator new to its host,
+// a benchmark app sets this by adding refx_LogAllocationCounter.cpp. Without it the benchmarks
+// report no allocation counts.
+long long ( *allocationsOnThisThread ) () = nullptr;
+
+// Cost of a message on the calling thread per level and sink configuration: throughput with one
+// and with several threads, percentiles of the per-call latency and allocations per message.
+// The results are written to the test log.
+
+class LoggingBenchmarks
+	: public juce::UnitTest
+{
+public:
+	LoggingBenchmarks ()
+		: juce::UnitTest ( "reFX logging benchmarks", "reFX" ) {}
+
+	void runTest () override
+	{
+		auto&	logging = *Logging::getInstance ();
+		auto	folder = juce::File::getSpecialLocation ( juce::File::tempDirectory ).getNonexistentChildFile ( "refx_logging_bench", {}, false );
+
+		{
+			ScopedLoggingState	state ( logging );
+
+			struct Config
+			{
+				const char*		name;
+				bool			toFile;
+				LogFileFormat	format;
+				bool			asynchronous;
+				bool			memoryMapped;
+			};
+
+			const Config	configs[] = {
+				{ "history only",			false,	LogFileFormat::text,	false,	false },
+				{ "text file",				true,	LogFileFormat::text,	false,	false },
+				{ "text file, async",		true,	LogFileFormat::text,	true,	false },
+				{ "text file, mapped",		true,	LogFileFormat::text,	false,	true },
+				{ "binary file",			true,	LogFileFormat::binary,	false,	false },
+				{ "binary file, async",		true,	LogFileFormat::binary,	true,	false },
+				{ "binary file, mapped",	true,	LogFileFormat::binary,	false,	true },
+			};
+
+			logMessage ( juce::String::formatted ( "%-20s %-10s %12s %12s %8s %8s %8s %10s", "sinks", "level", "msg/s 1 thr", "msg/s N thr", "p50 ns", "p99 ns", "p999 ns", "allocs/msg" ) );
+
+			for ( const auto& c : configs )
+			{
+				beginTest ( c.name );
+
+				LogWriterOptions	o;
+				o.format = c.format;
+				o.asynchronous = c.asynchronous;
+				o.memoryMapped = c.memoryMapped;
+				o.maxFileBytes = 16 * 1024 * 1024;
+				o.maxFiles = 2;
+
+				logging.setWriterOptions ( o );
+				logging.setLogFolder ( c.toFile ? folder : juce::File () );
+				logging.setLogLevel ( LogLevel::debuglog );
+
+				for ( auto i = int ( LogLevel::error ); i >= int ( LogLevel::debuglog ); --i )
+				{
+					const auto	level = LogLevel ( i );
+
+					report ( c.name, Logging::getLogLevelName ( level ), [ level ] ( int n )
+					{
+						Z_LOG_AT_LEVEL ( level, "benchmark message " << n << " value " << n * 0.5 );
+					} );
+				}
+
+				report ( c.name, "formatted", [] ( int n )
+				{
+					Z_FORMAT_AT_LEVEL ( LogLevel::info, "benchmark message {} value {}", n, n * 0.5 );
+				} );
+
+				// What a message costs that is filtered out by the level
+				logging.setLogLevel ( LogLevel::error );
+
+				report ( c.name, "disabled", [] ( int n )
+				{
+					Z_LOG_AT_LEVEL ( LogLevel::info, "benchmark message " << n << " value " << n * 0.5 );
+				} );
+			}
+		}
+
+		folder.deleteRecursively ();
+	}
+
+private:
+	static constexpr int	messagesPerRun = 20000;
+
+	template <typename LogFunction>
+	void report ( const char* config, const juce::String& level, LogFunction&& log )
+	{
+		using Clock = std::chrono::steady_clock;
+
+		// Single thread, every call timed on its own
+		std::vector<juce::int64>	latencies ( messagesPerRun );
+
+		auto		countAllocations = [] { return allocationsOnThisThread != nullptr ? allocationsOnThisThread () : 0; };
+		const auto	allocationsBefore = countAllocations ();
+		const auto	start = Clock::now ();
+
+		for ( int n = 0; n < messagesPerRun; ++n )
+		{
+			const auto	t0 = Clock::now ();
+			log ( n );
+			latencies[ size_t ( n ) ] = std::chrono::duration_cast<std::chrono::nanoseconds> ( Clock::now () - t0 ).count ();
+		}
+
+		const auto	singleSeconds = std::chrono::duration<double> ( Clock::now () - start ).count ();
+		const auto	allocations = allocationsOnThisThread != nullptr ? juce::String ( double ( countAllocations () - allocationsBefore ) / messagesPerRun, 2 ) : juce::String ( "-" );
+
+		std::sort ( latencies.begin (), latencies.end () );
+
+		auto	percentile = [ &latencies ] ( double p ) { return (long long) latencies[ std::min ( latencies.size () - 1, size_t ( p * double ( latencies.size () ) ) ) ]; };
+
+		// Several threads at once, contending for the queue and the sinks
+		const auto	numThreads = juce::jlimit ( 2, 8, juce::SystemStats::getNumCpus () );
+
+		std::atomic<bool>			go { false };
+		std::vector<std::thread>	threads;
+
+		for ( int t = 0; t < numThreads; ++t )
+		{
+			threads.emplace_back ( [ &go, &log ]
+			{
+				while ( ! go )
+					std::this_thread::yield ();
+
+				for ( int n = 0; n < messagesPerRun; ++n )
+					log ( n );
+			} );
+		}
+
+		const auto	multiStart = Clock::now ();
+		go = true;
+
+		for ( auto& t : threads )
+			t.join ();
+
+		const auto	multiSeconds = std::chrono::duration<double> ( Clock::now () - multiStart ).count ();
+
+		logMessage ( juce::String::formatted ( "%-20s %-10s %12.0f %12.0f %8lld %8lld %8lld %10s", config, level.toRawUTF8 (),
+											   messagesPerRun / singleSeconds, numThreads * messagesPerRun / multiSeconds,
+											   percentile ( 0.5 ), percentile ( 0.99 ), percentile ( 0.999 ), allocations.toRawUTF8 () ) );
+	}
+};
+
+static LoggingBenchmarks	loggingBenchmarks;
+
+#endif
+//-------------------------------------------------------------------------------------------------
+
+}
+
+#endif
@@ -1,12 +1,114 @@
-#include <ctime>
-
 #include "refx_LoggingWindow.h"
+#include "refx_LogFileView.h"
+#include "refx_LogSearch.h"
+#include "refx_LogSinks.h"
+#include "refx_BinaryLogFormat.h"
 
 //-------------------------------------------------------------------------------------------------
 
 namespace reFX
 {
 
+// Streams the support info to a file with a progress window, large logs take a while
+class LoggingWindow::SaveThread
+	: public juce::ThreadWithProgressWindow
+{
+public:
+	SaveThread ( LoggingWindow& o, const juce::File& f )
+		: juce::ThreadWithProgressWindow ( "Saving support info...", true, true, 10000, {}, &o )
+		, owner ( o )
+		, target ( f )
+	{
+	}
+
+	void run () override
+	{
+		// Written next to the target and swapped in when complete, a cancelled save leaves no half file
+		juce::TemporaryFile	temp ( target );
+
+		{
+			juce::FileOutputStream	out ( temp.getFile () );
+
+			if ( ! out.openedOk () )
+				return;
+
+			auto	progress = [ this ] ( double p )
+			{
+				setProgress ( p );
+				return ! threadShouldExit ();
+			};
+
+			const auto	ok = owner.opts.saveAsZip ? owner.logging.writeSupportZip ( out, progress )
+												  : owner.logging.writeSupportInfo ( out, progress );
+
+			out.flush ();
+
+			if ( ! ok || out.getStatus ().failed () )
+				return;
+		}
+
+		temp.overwriteTargetFileWithTemporary ();
+	}
+
+	void threadComplete ( bool ) override
+	{
+		owner.saveThread.reset ();
+	}
+
+private:
+	LoggingWindow&	owner;
+	juce::File		target;
+};
+//-------------------------------------------------------------------------------------------------
+
+// What the logging costs, refreshed twice a second while shown
+class LoggingWindow::DiagnosticsPanel
+	: public juce::Component
+	, private juce::Timer
+{
+public:
+	DiagnosticsPanel ( Logging& l, const juce::Font& f )
+		: logging ( l )
+		, font ( f )
+	{
+		timerCallback ();
+		startTimer ( 500 );
+	}
+
+	int getPreferredHeight () const		{ return lines.size () * lineHeight + 8; }
+
+	void paint ( juce::Graphics& g ) override
+	{
+		g.fillAll ( juce::Colour ( 0xff'13161B ) );
+		g.setColour ( juce::Colour ( 0xff'ACBDD5 ) );
+		g.setFont ( font );
+
+		auto	rc = getLocalBounds ().reduced ( 8, 4 );
+
+		for ( const auto& line : lines )
+			g.drawText ( line, rc.removeFromTop ( lineHeight ), juce::Justification::centredLeft, true );
+	}
+
+private:
+	static constexpr int	lineHeight = 18;
+
+	void timerCallback () override
+	{
+		const auto	newLines = juce::StringArray::fromLines ( logging.getStats ().toString ().trimEnd () );
+
+		if ( newLines == lines )
+			return;
+
+		lines = newLines;
+		repaint ();
+	}
+
+	Logging&			logging;
+	juce::Font			font;
+	juce::StringArray	lines;
+};
+//-------------------------------------------------------------------------------------------------
+
 LoggingWindow::Content::Content ( LoggingWindow& o )
 	: owner ( o )
 {
@@ -25,18 +127,40 @@ LoggingWindow::Content::Content ( LoggingWindow& o )
 	clearButton.setColour ( juce::TextButton::textColourOffId, txtCol );
 	clearButton.onClick = [ this ]
 	{
-		owner.logClearedTime = std::chrono::system_clock::to_time_t ( std::chrono::system_clock::now () );
+		owner.showLiveMessages ();
 		owner.update ();
+		owner.clearedSequence = owner.lastSequence;
+		owner.messages.clear ();
+		owner.searchResults.clear ();
+		owner.content.dbc.updateContent ();
+	};
+
+	addAndMakeVisible ( fileButton );
+	fileButton.setColour ( juce::TextButton::textColourOnId, txtCol );
+	fileButton.setColour ( juce::TextButton::textColourOffId, txtCol );
+	fileButton.onClick = [ this ]
+	{
+		if ( owner.isShowingLogFile () )
+			owner.showLiveMessages ();
+		else
+			owner.chooseLogFile ();
 	};
 
+	addAndMakeVisible ( searchBox );
+	searchBox.setTextToShowWhenEmpty ( "Search", txtCol.withAlpha ( 0.5f ) );
+	searchBox.setColour ( juce::TextEditor::backgroundColourId, juce::Colour ( 0xff'13161B ) );
+	searchBox.setColour ( juce::TextEditor::textColourId, txtCol );
+	searchBox.setColour ( juce::TextEditor::outlineColourId, juce::Colours::transparentBlack );
+	searchBox.onTextChange = [ this ] { owner.updateSearch (); };
+
+	addAndMakeVisible ( regexButton );
+	regexButton.setColour ( juce::ToggleButton::textColourId, txtCol );
+	regexButton.onClick = [ this ] { owner.updateSearch (); };
+
 	addAndMakeVisible ( saveButton );
 	saveButton.setColour ( juce::TextButton::textColourOnId, txtCol );
 	saveButton.setColour ( juce::TextButton::textColourOffId, txtCol );
-	saveButton.onClick = [ this ]
-	{
-		auto f = juce::File::getSpecialLocation ( juce::File::userDesktopDirectory ).getChildFile ( owner.getName ().replace ( "logging window", "Support Info" ) + ".txt" );
-		f.replaceWithText ( owner.logging.getAsString () );
-	};
+	saveButton.onClick = [ this ] { owner.saveSupportInfo (); };
 
    #if JUCE_DEBUG || REFX_DEVELOPMENT
 	addAndMakeVisible ( levelButton );
@@ -60,6 +184,22 @@ LoggingWindow::Content::Content ( LoggingWindow& o )
 
 		m.showMenuAsync ( juce::PopupMenu::Options ().withDeletionCheck ( *this ).withTargetComponent ( levelButton ) );
 	};
+
+	addAndMakeVisible ( sitesButton );
+	sitesButton.setColour ( juce::TextButton::textColourOnId, txtCol );
+	sitesButton.setColour ( juce::TextButton::textColourOffId, txtCol );
+	sitesButton.onClick = [ this ] { showCallSitesMenu (); };
+
+	addAndMakeVisible ( categoriesButton );
+	categoriesButton.setColour ( juce::TextButton::textColourOnId, txtCol );
+	categoriesButton.setColour ( juce::TextButton::textColourOffId, txtCol );
+	categoriesButton.onClick = [ this ] { showCategoriesMenu (); };
+
+	addAndMakeVisible ( statsButton );
+	statsButton.setClickingTogglesState ( true );
+	statsButton.setColour ( juce::TextButton::textColourOnId, txtCol );
+	statsButton.setColour ( juce::TextButton::textColourOffId, txtCol );
+	statsButton.onClick = [ this ] { toggleDiagnostics (); };
    #endif
 	owner.update ();
 }
@@ -72,12 +212,22 @@ void LoggingWindow::Content::resized ()
 	auto rc = bounds.removeFromTop ( 40 ).reduced ( 5 );
 
 	clearButton.setBounds ( rc.removeFromLeft ( 60 ).reduced ( 2 ) );
+	fileButton.setBounds ( rc.removeFromLeft ( 100 ).reduced ( 2 ) );
 	saveButton.setBounds ( rc.removeFromRight ( 120 ).reduced ( 2 ) );
    #if JUCE_DEBUG || REFX_DEVELOPMENT
 	rc.removeFromRight ( 4 );
 	levelButton.setBounds ( rc.removeFromRight ( 120 ).reduced ( 2 ) );
+	sitesButton.setBounds ( rc.removeFromRight ( 100 ).reduced ( 2 ) );
+	categoriesButton.setBounds ( rc.removeFromRight ( 100 ).reduced ( 2 ) );
+	statsButton.setBounds ( rc.removeFromRight ( 70 ).reduced ( 2 ) );
    #endif
 
+	regexButton.setBounds ( rc.removeFromRight ( 70 ).reduced ( 2 ) );
+	searchBox.setBounds ( rc.reduced ( 2 ) );
+
+	if ( owner.diagnostics )
+		owner.diagnostics->setBounds ( bounds.removeFromBottom ( owner.diagnostics->getPreferredHeight () ) );
+
 	dbc.setBounds ( bounds );
 }
 //-------------------------------------------------------------------------------------------------
@@ -90,65 +240,199 @@ void LoggingWindow::Content::paint ( juce::Graphics& g )
 
 int LoggingWindow::Content::getNumRows ()
 {
-	return owner.messages.size ();
+	if ( owner.fileView )
+		return owner.fileView->getNumLines ();
+
+	return owner.getShownMessages ().size ();
 }
 //-------------------------------------------------------------------------------------------------
 
 juce::String LoggingWindow::Content::getNameForRow ( int row )
 {
-	if ( juce::isPositiveAndBelow ( row, owner.messages.size () ) )
+	if ( owner.fileView )
 	{
-		const auto message = owner.messages[ row ];
-
-		// Compose final message
-		char dstTime[ 100 ] = { 0 };
-		std::strftime ( dstTime, sizeof ( dstTime ), "%T", std::localtime ( &message.timeStamp ) );
+		LogLevel	level;
+		return owner.fileView->getLine ( row, level );
+	}
 
-		return juce::String ( dstTime ) + " - " + message.description;
+	if ( const auto& shown = owner.getShownMessages (); juce::isPositiveAndBelow ( row, shown.size () ) )
+	{
+		return LogRowCache::formatRow ( shown.getReference ( row ) );
 	}
 
 	return {};
 }
 //-------------------------------------------------------------------------------------------------
 
-void LoggingWindow::Content::paintListBoxItem ( int row, juce::Graphics& g, int width, int height, bool /*rowIsSelected*/ )
+void LoggingWindow::Content::listBoxItemClicked ( int row, const juce::MouseEvent& e )
+{
+	if ( ! e.mods.isPopupMenu () || owner.fileView )
+		return;
+
+	if ( const auto& shown = owner.getShownMessages (); juce::isPositiveAndBelow ( row, shown.size () ) )
+		if ( const auto site = shown.getReference ( row ).site )
+			showCallSiteMenu ( *site );
+}
+//-------------------------------------------------------------------------------------------------
+
+static juce::String describeCallSite ( const LogCallSite& site )
+{
+	return site.getFileName () + ":" + juce::String ( site.line ) + " (" + juce::String ( site.hits.load () ) + " hits)";
+}
+//-------------------------------------------------------------------------------------------------
+
+void LoggingWindow::Content::showCallSiteMenu ( LogCallSite& site )
+{
+	juce::PopupMenu	m;
+
+	m.addSectionHeader ( describeCallSite ( site ) );
+	m.addItem ( juce::String ( site.function ) + ": " + site.text, false, false, nullptr );
+	m.addSeparator ();
+	// Sites are static objects, they outlive any menu
+	m.addItem ( "Log messages from here", true, site.enabled.load (), [ &site ] { site.enabled = ! site.enabled.load (); } );
+
+	m.showMenuAsync ( juce::PopupMenu::Options ().withDeletionCheck ( *this ) );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LoggingWindow::Content::showCallSitesMenu ()
+{
+	auto	sites = LogCallSite::getAll ();
+
+	// The busiest sites are the interesting ones
+	std::sort ( sites.begin (), sites.end (), [] ( auto a, auto b ) { return a->hits.load () > b->hits.load (); } );
+
+	juce::PopupMenu	m;
+
+	for ( size_t i = 0; i < juce::jmin ( sites.size (), size_t ( 40 ) ); ++i )
+	{
+		auto	site = sites[ i ];
+		m.addItem ( describeCallSite ( *site ), true, site->enabled.load (), [ site ] { site->enabled = ! site->enabled.load (); } );
+	}
+
+	m.addSeparator ();
+	m.addItem ( "Enable All", true, false, [ sites ]
+	{
+		for ( auto site : sites )
+			site->enabled = true;
+	} );
+
+   #if JUCE_DEBUG || REFX_DEVELOPMENT
+	m.showMenuAsync ( juce::PopupMenu::Options ().withDeletionCheck ( *this ).withTargetComponent ( sitesButton ) );
+   #else
+	m.showMenuAsync ( juce::PopupMenu::Options ().withDeletionCheck ( *this ) );
+   #endif
+}
+//-------------------------------------------------------------------------------------------------
+
+void LoggingWindow::Content::showCategoriesMenu ()
 {
-	if ( juce::isPositiveAndBelow ( row, owner.messages.size () ) )
+	juce::PopupMenu	m;
+
+	m.addItem ( "Show All", true, owner.shownCategory == nullptr, [ this ]
 	{
-		const auto message = owner.messages[ row ];
+		owner.shownCategory = nullptr;
+		owner.shownLevels = -1;
+		owner.update ();
+	} );
 
-		static juce::Colour	levels[][ 2 ] = {
-			{	juce::Colour ( 0xff'EBFD5A ),		juce::Colours::black	},	// dlog
-			{	juce::Colours::transparentBlack,	juce::Colours::white	},	// log
-			{   juce::Colour ( 0xFF'43A047 ),		juce::Colours::white	},	// info
-			{   juce::Colour ( 0xff'ECBF54 ),		juce::Colours::black	},	// warn
-			{	juce::Colour ( 0xff'FC5454 ),		juce::Colours::black	},	// err
-		};
+	m.addSeparator ();
 
-		// Compose final message
-		char dstTime[ 100 ] = { 0 };
-		std::strftime ( dstTime, sizeof ( dstTime ), "%T", std::localtime ( &message.timeStamp ) );
+	for ( auto category : LogCategory::getAll () )
+	{
+		juce::PopupMenu	sub;
 
-		const auto	text = juce::String ( dstTime ) + " - " + message.description;
+		sub.addItem ( "Show Only This", true, owner.shownCategory == category, [ this, category ]
+		{
+			owner.shownCategory = category;
+			owner.shownLevels = -1;
+			owner.update ();
+		} );
 
-		g.setFont ( owner.opts.font );
+		sub.addSeparator ();
+		sub.addItem ( "Inherit Level", true, ! category->hasOwnLevel (), [ this, category ]
+		{
+			category->inheritLevel ();
+			owner.update ();
+		} );
 
-		const auto	msgLevel = int ( message.level );
-		if ( const auto bckCol = levels[ msgLevel ][ 0 ]; ! bckCol.isTransparent () )
+		for ( auto i = int ( LogLevel::error ); i >= int ( LogLevel::debuglog ); --i )
 		{
-			const auto	textWidth = juce::GlyphArrangement::getStringWidth ( g.getCurrentFont (), text );
+			const auto	l = LogLevel ( i );
 
-			g.setColour ( bckCol );
-			g.fillRoundedRectangle ( juce::Rectangle<float>{ textWidth + 8.0f, float ( dbc.getRowHeight () ) }.reduced ( 0.0f, 1.5f ), 3.0f );
+			sub.addItem ( Logging::getLogLevelName ( l ), true, category->hasOwnLevel () && category->getOwnLevel () == l, [ this, category, l ]
+			{
+				category->setLevel ( l );
+				owner.update ();
+			} );
 		}
 
-		g.setColour ( levels[ msgLevel ][ 1 ] );
+		m.addSubMenu ( category->getName () + " (" + Logging::getLogLevelName ( category->getLevel () ) + ")", sub );
+	}
 
-		g.drawText (	text,
-						juce::Rectangle<int> ( width, height ).reduced ( 4, 0 ),
-						juce::Justification::centredLeft,
-						true );
+	m.showMenuAsync ( juce::PopupMenu::Options ().withDeletionCheck ( *this ).withTargetComponent ( categoriesButton ) );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LoggingWindow::Content::toggleDiagnostics ()
+{
+	if ( owner.diagnostics )
+	{
+		owner.diagnostics = nullptr;
+	}
+	else
+	{
+		owner.diagnostics = std::make_unique<DiagnosticsPanel> ( owner.logging, owner.opts.font );
+		addAndMakeVisible ( *owner.diagnostics );
 	}
+
+	resized ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LoggingWindow::Content::paintListBoxItem ( int row, juce::Graphics& g, int /*width*/, int height, bool /*rowIsSelected*/ )
+{
+	const auto	scale = g.getInternalContext ().getPhysicalPixelScaleFactor ();
+
+	if ( owner.fileView )
+	{
+		// Only the visible lines are ever read from the file
+		LogLevel	level;
+		const auto	line = owner.fileView->getLine ( row, level );
+
+		if ( line.isNotEmpty () )
+			paintRow ( g, owner.fileRows.getRow ( juce::uint64 ( row ), line, owner.opts.font, scale ), level, height );
+	}
+	else if ( const auto& shown = owner.getShownMessages (); juce::isPositiveAndBelow ( row, shown.size () ) )
+	{
+		const auto&	message = shown.getReference ( row );
+
+		paintRow ( g, owner.logging.getRowCache ().getRow ( message, owner.opts.font, scale ), message.level, height );
+	}
+}
+//-------------------------------------------------------------------------------------------------
+
+void LoggingWindow::Content::paintRow ( juce::Graphics& g, const LogRowCache::Row& cached, LogLevel level, int height )
+{
+	static juce::Colour	levels[][ 2 ] = {
+		{	juce::Colour ( 0xff'EBFD5A ),		juce::Colours::black	},	// dlog
+		{	juce::Colours::transparentBlack,	juce::Colours::white	},	// log
+		{   juce::Colour ( 0xFF'43A047 ),		juce::Colours::white	},	// info
+		{   juce::Colour ( 0xff'ECBF54 ),		juce::Colours::black	},	// warn
+		{	juce::Colour ( 0xff'FC5454 ),		juce::Colours::black	},	// err
+	};
+
+	const auto	msgLevel = int ( level );
+	if ( const auto bckCol = levels[ msgLevel ][ 0 ]; ! bckCol.isTransparent () )
+	{
+		g.setColour ( bckCol );
+		g.fillRoundedRectangle ( juce::Rectangle<float>{ cached.width + 8.0f, float ( dbc.getRowHeight () ) }.reduced ( 0.0f, 1.5f ), 3.0f );
+	}
+
+	g.setColour ( levels[ msgLevel ][ 1 ] );
+
+	// Glyphs outside the row are clipped by the list box
+	LogRowCache::drawRow ( g, cached, owner.opts.font, 4.0f, height );
 }
 //-------------------------------------------------------------------------------------------------
 
@@ -225,12 +509,22 @@ LoggingWindow::LoggingWindow ( Logging& l, const LoggingOptions& opts_ )
 
 	logging.setLogLevel ( ( LogLevel ) ( int ) json.getProperty ( "/log_level", ( int ) LogLevel::debuglog ) );
 
+	if ( auto levels = json.getProperty ( "/log_categories", {} ).getDynamicObject () )
+		for ( const auto& p : levels->getProperties () )
+			LogCategory::get ( p.name.toString () ).setLevel ( ( LogLevel ) ( int ) p.value );
+
+	if ( const auto shown = json.getProperty ( "/log_category", "" ).toString (); shown.isNotEmpty () )
+		shownCategory = &LogCategory::get ( shown );
+
 	update ();
 }
 //-------------------------------------------------------------------------------------------------
 
 LoggingWindow::~LoggingWindow ()
 {
+	saveThread = nullptr;
+	diagnostics = nullptr;
+
 	setLookAndFeel ( nullptr );
 
 	if ( everShown )
@@ -244,6 +538,15 @@ LoggingWindow::~LoggingWindow ()
 		obj->setProperty ( juce::String ( "/window_pos" ), getWindowStateAsString () );
 	   #if JUCE_DEBUG || REFX_DEVELOPMENT
 		obj->setProperty ( "/log_level", ( int ) logging.getLogLevel () );
+
+		auto	levels = new juce::DynamicObject ();
+
+		for ( auto category : LogCategory::getAll () )
+			if ( category->hasOwnLevel () )
+				levels->setProperty ( category->getName (), ( int ) category->getOwnLevel () );
+
+		obj->setProperty ( "/log_categories", juce::var ( levels ) );
+		obj->setProperty ( "/log_category", shownCategory != nullptr ? shownCategory->getName () : juce::String () );
 	   #endif
 		settingsFile.replaceWithText ( juce::JSON::toString ( juce::var ( obj ) ) );
 	}
@@ -265,17 +568,201 @@ void LoggingWindow::visibilityChanged ()
 
 void LoggingWindow::update ()
 {
-	messages.clear ();
+	const auto	level = logging.getLogLevel ();
+	const auto	levels = LogCategory::getGeneration ();
+
+	// Only a different filter needs everything again, otherwise just the new messages are pulled
+	if ( int ( level ) != shownLevel || levels != shownLevels )
+	{
+		shownLevel = int ( level );
+		shownLevels = levels;
+		lastSequence = clearedSequence;
+		messages.clearQuick ();
+
+		if ( searchActive )
+			updateSearch ();
+	}
+
+	juce::Array<LogMessage>	fresh;
+	lastSequence = logging.getMessagesSince ( lastSequence, fresh );
 
-	for ( auto m : logging.getMessages () )
-		if ( m.timeStamp >= logClearedTime && m.level >= logging.getLogLevel () )
+	if ( fresh.isEmpty () && ! messages.isEmpty () )
+		return;
+
+	for ( const auto& m : fresh )
+		if ( isShown ( m ) )
 			messages.add ( m );
 
+	// Never show more than the history holds, trimmed in chunks to keep appending cheap
+	const auto	capacity = logging.getHistoryCapacity ();
+
+	if ( messages.size () > capacity + capacity / 4 )
+		messages.removeRange ( 0, messages.size () - capacity );
+
+	// The search matches new messages as well, its results are picked up by the timer
+	if ( search )
+		search->messagesAdded ();
+
+	// New messages are still collected while a file is shown or a search runs
+	if ( fileView || searchActive )
+		return;
+
 	content.dbc.updateContent ();
 	content.dbc.scrollToEnsureRowIsOnscreen ( messages.size () - 1 );
 }
 //-------------------------------------------------------------------------------------------------
 
+void LoggingWindow::showLogFile ( const juce::File& f )
+{
+	fileView = std::make_unique<LogFileView> ( f );
+	fileRows.clear ();
+	shownFileLines = 0;
+
+	content.fileButton.setButtonText ( "Back to Live" );
+	content.dbc.updateContent ();
+	content.dbc.scrollToEnsureRowIsOnscreen ( 0 );
+
+	// The line count grows while the file is indexed
+	startTimer ( 100 );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LoggingWindow::showLiveMessages ()
+{
+	if ( ! fileView )
+		return;
+
+	fileView = nullptr;
+	fileRows.clear ();
+
+	content.fileButton.setButtonText ( "Open Log..." );
+	content.dbc.updateContent ();
+	content.dbc.scrollToEnsureRowIsOnscreen ( getShownMessages ().size () - 1 );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LoggingWindow::timerCallback ()
+{
+	auto	keepPolling = false;
+
+	if ( fileView )
+	{
+		const auto	indexing = fileView->isIndexing ();
+		const auto	numLines = fileView->getNumLines ();
+
+		if ( numLines != shownFileLines )
+		{
+			shownFileLines = numLines;
+			content.dbc.updateContent ();
+		}
+
+		// The line count grows while the file is indexed
+		keepPolling = indexing;
+	}
+
+	if ( searchActive )
+	{
+		pullSearchResults ();
+		keepPolling = true;
+	}
+
+	if ( ! keepPolling )
+		stopTimer ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LoggingWindow::updateSearch ()
+{
+	const auto	text = content.searchBox.getText ();
+
+	searchActive = text.isNotEmpty ();
+	searchResults.clearQuick ();
+
+	if ( searchActive && ! search )
+		search = std::make_unique<LogSearch> ( logging );
+
+	// Cancels the search that is still running for the previous text
+	if ( search )
+		search->setQuery ( text, content.regexButton.getToggleState () );
+
+	content.searchBox.setColour ( juce::TextEditor::textColourId, juce::Colour ( 0xff'ACBDD5 ) );
+
+	if ( ! fileView )
+	{
+		content.dbc.updateContent ();
+		content.dbc.scrollToEnsureRowIsOnscreen ( getShownMessages ().size () - 1 );
+	}
+
+	// Results are streamed in while the search runs
+	if ( searchActive )
+		startTimer ( 100 );
+}
+//-------------------------------------------------------------------------------------------------
+
+void LoggingWindow::pullSearchResults ()
+{
+	juce::Array<LogMessage>	found;
+	search->takeResults ( found );
+
+	if ( ! search->isQueryValid () )
+		content.searchBox.setColour ( juce::TextEditor::textColourId, juce::Colour ( 0xff'FC5454 ) );
+
+	if ( found.isEmpty () )
+		return;
+
+	// The same filter as the live list, the search itself only matches the text
+	for ( const auto& m : found )
+		if ( isShown ( m ) && m.sequence > clearedSequence )
+			searchResults.add ( m );
+
+	const auto	capacity = logging.getHistoryCapacity ();
+
+	if ( searchResults.size () > capacity + capacity / 4 )
+		searchResults.removeRange ( 0, searchResults.size () - capacity );
+
+	if ( ! fileView )
+		content.dbc.updateContent ();
+}
+//-------------------------------------------------------------------------------------------------
+
+bool LoggingWindow::isShown ( const LogMessage& m ) const
+{
+	const auto	category = m.site != nullptr ? m.site->category : nullptr;
+
+	if ( shownCategory != nullptr && ( category == nullptr || ! category->isWithin ( *shownCategory ) ) )
+		return false;
+
+	// A category can let messages through that are below the global level
+	return category != nullptr ? category->isEnabled ( m.level ) : int ( m.level ) >= shownLevel;
+}
+//-------------------------------------------------------------------------------------------------
+
+void LoggingWindow::saveSupportInfo ()
+{
+	if ( saveThread != nullptr )
+		return;
+
+	const auto	name = getName ().replace ( "logging window", "Support Info" ) + ( opts.saveAsZip ? ".zip" : ".txt" );
+
+	saveThread = std::make_unique<SaveThread> ( *this, juce::File::getSpecialLocation ( juce::File::userDesktopDirectory ).getChildFile ( name ) );
+	saveThread->launchThread ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void LoggingWindow::chooseLogFile ()
+{
+	const auto	files = logging.getFileSink ()->getWriter ().getLogFiles ();
+	const auto	folder = files.empty () ? juce::File::getSpecialLocation ( juce::File::userDocumentsDirectory ) : files.front ().file.getParentDirectory ();
+
+	chooser = std::make_unique<juce::FileChooser> ( "Open Log File", folder, "*.txt;*" + juce::String ( BinaryLogFormat::fileExtension ) + ";*" + BinaryLogFormat::compressedFileExtension );
+	chooser->launchAsync ( juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles, [ this ] ( const juce::FileChooser& fc )
+	{
+		if ( const auto f = fc.getResult (); f.existsAsFile () )
+			showLogFile ( f );
+	} );
+}
+//-------------------------------------------------------------------------------------------------
+
 float LoggingWindow::getDesktopScaleFactor () const
 {
 	return opts.scale * juce::Desktop::getInstance ().getGlobalScaleFactor ();
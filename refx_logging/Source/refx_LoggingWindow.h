@@ -8,6 +8,7 @@ namespace reFX
 
 class LoggingWindow
 	: public juce::DocumentWindow
+	, private juce::Timer
 {
 public:
 	LoggingWindow ( Logging&, const LoggingOptions& );
@@ -16,12 +17,29 @@ public:
 	void update ();
 	void visibilityChanged () override;
 
+	// Shows a log file, e.g. of an earlier session, instead of the messages of this session
+	void showLogFile ( const juce::File& );
+	void showLiveMessages ();
+	bool isShowingLogFile () const		{ return fileView != nullptr; }
+
 private:
 	void closeButtonPressed () override;
 	float getDesktopScaleFactor () const override;
+	void timerCallback () override;
+	void chooseLogFile ();
+	void updateSearch ();
+	void pullSearchResults ();
+	void saveSupportInfo ();
+	bool isShown ( const LogMessage& ) const;
+
+	// The search results while searching, otherwise the live messages
+	juce::Array<LogMessage>& getShownMessages ()	{ return searchActive ? searchResults : messages; }
 
 	//-------------------------------------------------------------------------------------------------
 
+	class SaveThread;
+	class DiagnosticsPanel;
+
 	class Content
 		: public juce::Component
 		, public juce::ListBoxModel
@@ -34,14 +52,28 @@ private:
 		void resized () override;
 		void paint ( juce::Graphics& g ) override;
 		juce::String getNameForRow ( int row ) override;
+		void listBoxItemClicked ( int row, const juce::MouseEvent& ) override;
+		void paintRow ( juce::Graphics&, const LogRowCache::Row&, LogLevel, int height );
+
+		// Switching call sites on and off, for a message or the busiest sites
+		void showCallSiteMenu ( LogCallSite& );
+		void showCallSitesMenu ();
+		void showCategoriesMenu ();
+		void toggleDiagnostics ();
 
 		LoggingWindow&		owner;
 
 		juce::ListBox		dbc;
 		juce::TextButton	clearButton { "Clear" };
+		juce::TextButton	fileButton { "Open Log..." };
+		juce::TextEditor	searchBox;
+		juce::ToggleButton	regexButton { "Regex" };
 		juce::TextButton	saveButton { "Save to Desktop" };
 	   #if JUCE_DEBUG || REFX_DEVELOPMENT
 		juce::TextButton	levelButton { "Level" };
+		juce::TextButton	sitesButton { "Call Sites" };
+		juce::TextButton	categoriesButton { "Categories" };
+		juce::TextButton	statsButton { "Stats" };
 	   #endif
 	};
 
@@ -50,10 +82,26 @@ private:
 	std::unique_ptr<juce::LookAndFeel>	laf;
 	juce::Array<LogMessage> messages;
 
-	time_t 				logClearedTime = 0;
+	juce::uint64		clearedSequence = 0;	// Messages up to here were cleared by the user
+	juce::uint64		lastSequence = 0;		// Messages up to here have been pulled from the history
+	int					shownLevel = -1;		// Level the messages were filtered with
+	int					shownLevels = -1;		// LogCategory generation the messages were filtered with
+	LogCategory*		shownCategory = nullptr;	// Only this category and its children, null for all messages
 	bool				everShown = false;
 	LoggingOptions		opts;
 
+	std::unique_ptr<LogFileView>		fileView;
+	LogRowCache							fileRows;			// Keyed by line number
+	int									shownFileLines = 0;
+	std::unique_ptr<juce::FileChooser>	chooser;
+
+	std::unique_ptr<LogSearch>			search;				// Created by the first search, then follows the log
+	juce::Array<LogMessage>				searchResults;
+	bool								searchActive = false;
+
+	std::unique_ptr<SaveThread>			saveThread;			// Writes the support info while the save button is busy
+	std::unique_ptr<DiagnosticsPanel>	diagnostics;		// Logging's own stats below the messages, see Logging::getStats
+
 	Content				content { *this };
 
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoggingWindow)
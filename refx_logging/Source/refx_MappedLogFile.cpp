@@ -0,0 +1,311 @@
+#include "refx_MappedLogFile.h"
+
+//-------------------------------------------------------------------------------------------------
+
+namespace reFX
+{
+
+static const char	mappedLogMagic[ 7 ] = { 'R', 'F', 'X', 'M', 'A', 'P', ' ' };
+
+// Offsets of the two copies of the committed end and of the process id in the header
+static constexpr int	committedEndOffsets[ 2 ] = { 7, 24 };
+static constexpr int	processIdOffset = 41;
+
+//-------------------------------------------------------------------------------------------------
+
+MappedLogFile::MappedLogFile ( const juce::File& f )
+	: file ( f )
+{
+	if ( ! mapNextSegment () )
+		return;
+
+	auto	text = static_cast<char*> ( header->getData () );
+
+	std::memset ( text, ' ', headerSize );
+	std::memcpy ( text, mappedLogMagic, sizeof ( mappedLogMagic ) );
+
+	const auto	processId = juce::String::toHexString ( juce::int64 ( getProcessId () ) ).paddedLeft ( '0', 8 );
+	std::memcpy ( text + processIdOffset, processId.toRawUTF8 (), 8 );
+
+	text[ headerSize - 2 ] = '\r';
+	text[ headerSize - 1 ] = '\n';
+
+	position = headerSize;
+	isOpen = true;
+	commit ();
+}
+//-------------------------------------------------------------------------------------------------
+
+MappedLogFile::~MappedLogFile ()
+{
+	close ();
+}
+//-------------------------------------------------------------------------------------------------
+
+void MappedLogFile::commit () noexcept
+{
+	if ( header == nullptr || committed == position )
+		return;
+
+	char	digits[ 16 ];
+	auto	value = juce::uint64 ( position );
+
+	for ( int i = 15; i >= 0; --i, value >>= 4 )
+		digits[ i ] = "0123456789abcdef"[ value & 15 ];
+
+	// The data has to be in the mapping before the header says so
+	std::atomic_signal_fence ( std::memory_order_release );
+
+	const auto	text = static_cast<char*> ( header->getData () );
+
+	for ( auto offset : committedEndOffsets )
+		std::memcpy ( text + offset, digits, sizeof ( digits ) );
+
+	committed = position;
+}
+//-------------------------------------------------------------------------------------------------
+
+void MappedLogFile::close ()
+{
+	if ( ! isOpen )
+		return;
+
+	isOpen = false;
+
+	commit ();
+
+	// Mapped regions cannot be cut off on every platform
+	header = nullptr;
+	segment = nullptr;
+	segmentData = nullptr;
+
+	setFileSize ( file, committed, false );
+}
+//-------------------------------------------------------------------------------------------------
+
+bool MappedLogFile::write ( const void* data, size_t numBytes )
+{
+	if ( header == nullptr )
+		return false;
+
+	auto	src = static_cast<const char*> ( data );
+
+	while ( numBytes > 0 )
+	{
+		if ( position == segmentEnd && ! mapNextSegment () )
+		{
+			failed = true;
+			return false;
+		}
+
+		const auto	n = std::min ( numBytes, size_t ( segmentEnd - position ) );
+
+		std::memcpy ( segmentData + ( position - segmentStart ), src, n );
+
+		position += juce::int64 ( n );
+		src += n;
+		numBytes -= n;
+	}
+
+	return true;
+}
+//-------------------------------------------------------------------------------------------------
+
+bool MappedLogFile::mapNextSegment ()
+{
+	const auto	start = segmentEnd;
+	const auto	end = start + segmentSize;
+
+	// Windows does not let a file grow while it is mapped. Earlier segments stay in the file, their
+	// pages are written back without the mapping.
+	header = nullptr;
+	segment = nullptr;
+	segmentData = nullptr;
+
+	if ( setFileSize ( file, end, true ) && map ( start, end ) )
+		return true;
+
+	// The full segment is mapped again, so commit () and close () keep working after a failed grow
+	if ( start > segmentStart )
+		map ( segmentStart, start );
+
+	return false;
+}
+//-------------------------------------------------------------------------------------------------
+
+bool MappedLogFile::map ( juce::int64 start, juce::int64 end )
+{
+	auto	h = std::make_unique<juce::MemoryMappedFile> ( file, juce::Range<juce::int64> ( 0, headerSize ), juce::MemoryMappedFile::readWrite );
+	auto	s = std::make_unique<juce::MemoryMappedFile> ( file, juce::Range<juce::int64> ( start, end ), juce::MemoryMappedFile::readWrite );
+
+	if ( h->getData () == nullptr || s->getData () == nullptr || s->getRange ().getStart () != start )
+		return false;
+
+	header = std::move ( h );
+	segment = std::move ( s );
+	segmentData = static_cast<char*> ( segment->getData () );
+	segmentStart = start;
+	segmentEnd = end;
+
+	return true;
+}
+//-------------------------------------------------------------------------------------------------
+
+bool MappedLogFile::setFileSize ( const juce::File& f, juce::int64 size, bool zeroFill )
+{
+	juce::FileOutputStream	out ( f );
+
+	if ( ! out.openedOk () )
+		return false;
+
+	if ( ! zeroFill || out.getPosition () >= size )
+		return out.setPosition ( size ) && out.truncate ().wasOk ();
+
+	// Zeros instead of a sparse extension, so a full disk fails here instead of faulting a write
+	// into the mapping
+	juce::HeapBlock<char>	zeros ( 65536, true );
+
+	while ( out.getPosition () < size )
+		if ( ! out.write ( zeros, size_t ( std::min<juce::int64> ( 65536, size - out.getPosition () ) ) ) )
+			return false;
+
+	out.flush ();
+
+	return out.getStatus ().wasOk ();
+}
+//-------------------------------------------------------------------------------------------------
+
+std::optional<juce::int64> MappedLogFile::readCommittedEnd ( juce::InputStream& in )
+{
+	char	text[ headerSize ];
+
+	if ( in.read ( text, headerSize ) != headerSize )
+		return {};
+
+	return readCommittedEnd ( text, headerSize );
+}
+//-------------------------------------------------------------------------------------------------
+
+std::optional<juce::int64> MappedLogFile::readCommittedEnd ( const void* data, size_t size )
+{
+	const auto	text = static_cast<const char*> ( data );
+
+	if ( size < size_t ( headerSize ) || std::memcmp ( text, mappedLogMagic, sizeof ( mappedLogMagic ) ) != 0 )
+		return {};
+
+	// A crash while the header was updated leaves one copy old or torn, the smaller one is safe
+	auto	end = std::numeric_limits<juce::int64>::max ();
+
+	for ( auto offset : committedEndOffsets )
+	{
+		juce::uint64	value = 0;
+
+		for ( int i = 0; i < 16; ++i )
+		{
+			const auto	digit = juce::CharacterFunctions::getHexDigitValue ( juce::juce_wchar ( text[ offset + i ] ) );
+
+			if ( digit < 0 )
+				return juce::int64 ( headerSize );
+
+			value = ( value << 4 ) | juce::uint64 ( digit );
+		}
+
+		if ( value < juce::uint64 ( end ) )
+			end = juce::int64 ( value );
+	}
+
+	return std::max ( end, juce::int64 ( headerSize ) );
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::int64 MappedLogFile::recover ( const juce::File& f )
+{
+	juce::int64		end, size;
+	juce::uint32	processId = 0;
+
+	{
+		juce::FileInputStream	in ( f );
+
+		if ( ! in.openedOk () )
+			return -1;
+
+		char	text[ headerSize ];
+
+		if ( in.read ( text, headerSize ) != headerSize )
+			return -1;
+
+		const auto	committedEnd = readCommittedEnd ( text, headerSize );
+
+		if ( ! committedEnd )
+			return -1;
+
+		// Files of older versions have spaces there and stay 0
+		for ( int i = 0; i < 8; ++i )
+		{
+			const auto	digit = juce::CharacterFunctions::getHexDigitValue ( juce::juce_wchar ( text[ processIdOffset + i ] ) );
+
+			if ( digit < 0 )
+			{
+				processId = 0;
+				break;
+			}
+
+			processId = ( processId << 4 ) | juce::uint32 ( digit );
+		}
+
+		size = in.getTotalLength ();
+		end = std::min ( *committedEnd, size );
+	}
+
+	if ( size == end )
+		return size;
+
+	// Another process that shares the log folder may still be writing it. Files of this process are
+	// closed before the writer recovers the folder, and locking its own session lock a second time
+	// would release it on POSIX.
+	std::unique_ptr<juce::InterProcessLock>	lock;
+
+	if ( processId != 0 && processId != getProcessId () )
+	{
+		lock = std::make_unique<juce::InterProcessLock> ( getSessionLockName ( f.getParentDirectory (), processId ) );
+
+		if ( ! lock->enter ( 0 ) )
+			return -1;
+	}
+
+	// The zero-filled rest of the last segment
+	if ( setFileSize ( f, end, false ) )
+		size = end;
+
+	if ( lock != nullptr )
+		lock->exit ();
+
+	return size;
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String MappedLogFile::getSessionLockName ( const juce::File& folder )
+{
+	return getSessionLockName ( folder, getProcessId () );
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String MappedLogFile::getSessionLockName ( const juce::File& folder, juce::uint32 processId )
+{
+	return "reFX_log_" + juce::String::toHexString ( folder.getFullPathName ().hashCode64 () ) + "_" + juce::String::toHexString ( juce::int64 ( processId ) );
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::uint32 MappedLogFile::getProcessId ()
+{
+#if JUCE_MAC || JUCE_LINUX
+	return juce::uint32 ( getpid () );
+#elif JUCE_WINDOWS
+	return juce::uint32 ( GetCurrentProcessId () );
+#else
+	#error "Unknown platform!"
+#endif
+}
+//-------------------------------------------------------------------------------------------------
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+namespace reFX
+{
+//-------------------------------------------------------------------------------------------------
+// Log file written through memory mappings, see LogWriterOptions::memoryMapped. Written bytes are
+// in pages the kernel owns, so they survive a crash of the process without any write or flush
+// calls (a power loss still needs the OS to have written them back).
+//
+// The file starts with a header line that holds the end of the committed data twice and the id of
+// the writing process:
+//
+//	"RFXMAP <16 hex digits> <16 hex digits> <8 hex digits>" padded with spaces to headerSize, ending in "\r\n"
+//
+// Readers use the smaller value, so a header torn by a crash never points past a complete
+// message. The file grows in zero-filled segments of segmentSize bytes. Closing cuts off the
+// unused end, recover () does the same for files left behind by a crash. The writing process holds
+// the session lock of the folder (see getSessionLockName) while its files are open, so recovery
+// never cuts a file another process still writes. One lock per session instead of one per file
+// keeps the lock files JUCE leaves in the temp folder from piling up.
+
+class MappedLogFile
+	: public juce::OutputStream
+{
+public:
+	static constexpr int			headerSize = 64;
+	static constexpr juce::int64	segmentSize = 4 * 1024 * 1024;
+
+	explicit MappedLogFile ( const juce::File& );
+	~MappedLogFile () override;
+
+	bool openedOk () const					{ return isOpen; }
+	bool failedToOpen () const				{ return ! isOpen; }
+	const juce::File& getFile () const		{ return file; }
+
+	// A write could not grow the file, e.g. on a full disk. Everything committed before stays and
+	// close () still cuts the file to it.
+	bool writeFailed () const				{ return failed; }
+
+	// Publishes everything written so far, only a store into the mapped header
+	void commit () noexcept;
+
+	// Unmaps the file and cuts it to the committed size
+	void close ();
+
+	void flush () override								{ commit (); }
+	bool setPosition ( juce::int64 ) override			{ return false; }
+	juce::int64 getPosition () override					{ return position; }
+	bool write ( const void* data, size_t numBytes ) override;
+
+	// End of the committed data in a stream or memory that starts with a header, or nullopt if
+	// it is no mapped log file
+	static std::optional<juce::int64> readCommittedEnd ( juce::InputStream& );
+	static std::optional<juce::int64> readCommittedEnd ( const void* data, size_t size );
+
+	// Cuts a mapped log file back to its committed end. Returns its size afterwards, or -1 if it is
+	// no mapped log file or its process still holds the session lock.
+	static juce::int64 recover ( const juce::File& );
+
+	// The inter-process lock a writer holds while it has mapped files in the folder open
+	static juce::String getSessionLockName ( const juce::File& folder );
+
+private:
+	bool mapNextSegment ();
+	bool map ( juce::int64 start, juce::int64 end );
+	static bool setFileSize ( const juce::File&, juce::int64 size, bool zeroFill );
+	static juce::String getSessionLockName ( const juce::File& folder, juce::uint32 processId );
+	static juce::uint32 getProcessId ();
+
+	const juce::File						file;
+	std::unique_ptr<juce::MemoryMappedFile>	header;
+	std::unique_ptr<juce::MemoryMappedFile>	segment;
+	char*									segmentData = nullptr;
+	juce::int64								segmentStart = 0;
+	juce::int64								segmentEnd = 0;
+	juce::int64								position = 0;
+	juce::int64								committed = 0;
+	bool									isOpen = false;
+	bool									failed = false;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR ( MappedLogFile )
+};
+//-------------------------------------------------------------------------------------------------
+}
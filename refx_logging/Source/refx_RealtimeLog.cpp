@@ -0,0 +1,85 @@
+#include <cstdio>
+
+#include "refx_RealtimeLog.h"
+
+//-------------------------------------------------------------------------------------------------
+
+namespace reFX
+{
+
+void LogArg::writeTo ( juce::OutputStream& out ) const
+{
+	char	number[ 32 ];
+	auto	length = 0;
+
+	switch ( type )
+	{
+		case Type::signedInt:		length = std::snprintf ( number, sizeof ( number ), "%lld", (long long) i ); break;
+		case Type::unsignedInt:		length = std::snprintf ( number, sizeof ( number ), "%llu", (unsigned long long) u ); break;
+		case Type::floatingPoint:	length = std::snprintf ( number, sizeof ( number ), "%.9g", d ); break;
+		case Type::pointer:			length = std::snprintf ( number, sizeof ( number ), "0x%llx", (unsigned long long) juce::pointer_sized_uint ( p ) ); break;
+		case Type::boolean:			out.write ( u != 0 ? "true" : "false", u != 0 ? 4 : 5 ); break;
+		case Type::text:
+		{
+			const auto	text = s != nullptr ? s : "(null)";
+			out.write ( text, std::strlen ( text ) );
+			break;
+		}
+		case Type::none:
+		default:					break;
+	}
+
+	if ( length > 0 )
+		out.write ( number, size_t ( length ) );
+}
+//-------------------------------------------------------------------------------------------------
+
+juce::String formatLogMessage ( const char* format, const LogArg* args, int numArgs )
+{
+	if ( format == nullptr )
+		return {};
+
+	// Keeps its memory between messages
+	thread_local juce::MemoryOutputStream	text;
+
+	text.reset ();
+
+	auto	literalStart = format;
+	auto	nextArg = 0;
+
+	auto	appendLiteral = [ & ] ( const char* end )
+	{
+		if ( end > literalStart )
+			text.write ( literalStart, size_t ( end - literalStart ) );
+	};
+
+	for ( auto p = format; *p != 0; ++p )
+	{
+		const auto	escaped = ( p[ 0 ] == '{' && p[ 1 ] == '{' ) || ( p[ 0 ] == '}' && p[ 1 ] == '}' );
+		const auto	placeholder = p[ 0 ] == '{' && p[ 1 ] == '}';
+
+		if ( escaped )
+		{
+			appendLiteral ( p + 1 );
+			literalStart = ++p + 1;
+		}
+		else if ( placeholder )
+		{
+			appendLiteral ( p );
+
+			if ( nextArg < numArgs )
+				args[ nextArg++ ].writeTo ( text );
+			else
+				text.write ( "{}", 2 );
+
+			literalStart = ++p + 1;
+		}
+	}
+
+	appendLiteral ( literalStart + std::strlen ( literalStart ) );
+
+	return juce::String::fromUTF8 ( static_cast<const char*> ( text.getData () ), int ( text.getDataSize () ) );
+}
+//-------------------------------------------------------------------------------------------------
+
+}
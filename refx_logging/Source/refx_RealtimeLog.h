@@ -0,0 +1,167 @@
+#pragma once
+
+#include <type_traits>
+
+//-------------------------------------------------------------------------------------------------
+// Real-time safe logging, e.g. from an audio callback. Nothing is formatted or allocated on the
+// calling thread: the format string pointer and the arguments are copied into a preallocated
+// lock-free queue and formatted later by a non real-time thread. Use {} as placeholder.
+// String arguments must be string literals or otherwise outlive the call.
+
+#define	Z_RT_AT_LEVEL(_l, ...)	{ if ( ::reFX::Logging::isLevelEnabled ( _l ) ) { Z_LOG_CALL_SITE ( _l, #__VA_ARGS__ ); if ( zCallSite.hit () ) ::reFX::Logging::logRealtime ( _l, &zCallSite, __VA_ARGS__ ); } }
+
+#if REFX_LOG_MIN_LEVEL <= 4
+	#define	Z_RT_ERR(...)	Z_RT_AT_LEVEL ( ::reFX::LogLevel::error, __VA_ARGS__ )
+#else
+	#define Z_RT_ERR(...)
+#endif
+
+#if REFX_LOG_MIN_LEVEL <= 3
+	#define	Z_RT_WARN(...)	Z_RT_AT_LEVEL ( ::reFX::LogLevel::warning, __VA_ARGS__ )
+#else
+	#define Z_RT_WARN(...)
+#endif
+
+#if REFX_LOG_MIN_LEVEL <= 2
+	#define	Z_RT_INFO(...)	Z_RT_AT_LEVEL ( ::reFX::LogLevel::info, __VA_ARGS__ )
+#else
+	#define Z_RT_INFO(...)
+#endif
+
+#if ( REFX_DEVELOPMENT || _DEBUG ) && REFX_LOG_MIN_LEVEL <= 1
+	#define Z_RT_LOG(...)	Z_RT_AT_LEVEL ( ::reFX::LogLevel::log, __VA_ARGS__ )
+#else
+	#define Z_RT_LOG(...)
+#endif
+
+#if defined ( _DEBUG ) && REFX_LOG_MIN_LEVEL <= 0
+	#define Z_RT_DLOG(...)	Z_RT_AT_LEVEL ( ::reFX::LogLevel::debuglog, __VA_ARGS__ )
+#else
+	#define Z_RT_DLOG(...)
+#endif
+
+namespace reFX
+{
+//-------------------------------------------------------------------------------------------------
+
+struct LogArg
+{
+	enum class Type : juce::uint8
+	{
+		none,
+		signedInt,
+		unsignedInt,
+		floatingPoint,
+		boolean,
+		text,
+		pointer,
+	};
+
+	LogArg () = default;
+
+	template <typename T>
+	LogArg ( const T& v )
+	{
+		using D = std::decay_t<T>;
+
+		if constexpr ( std::is_same<D, bool>::value )							{ type = Type::boolean;			u = v ? 1 : 0; }
+		else if constexpr ( std::is_enum<D>::value )							{ type = Type::signedInt;		i = juce::int64 ( v ); }
+		else if constexpr ( std::is_integral<D>::value && std::is_signed<D>::value )	{ type = Type::signedInt;		i = juce::int64 ( v ); }
+		else if constexpr ( std::is_integral<D>::value )						{ type = Type::unsignedInt;		u = juce::uint64 ( v ); }
+		else if constexpr ( std::is_floating_point<D>::value )					{ type = Type::floatingPoint;	d = double ( v ); }
+		else if constexpr ( std::is_same<D, const char*>::value || std::is_same<D, char*>::value )	{ type = Type::text;	s = v; }
+		else if constexpr ( std::is_same<D, juce::String>::value )				{ type = Type::text;			s = v.toRawUTF8 (); }
+		else if constexpr ( std::is_same<D, std::string>::value )				{ type = Type::text;			s = v.c_str (); }
+		else
+		{
+			static_assert ( std::is_pointer<D>::value, "Only numbers, bools, enums, pointers and strings can be logged" );
+			type = Type::pointer;
+			p = v;
+		}
+	}
+
+	// Appends the argument as UTF-8 text
+	void writeTo ( juce::OutputStream& ) const;
+
+	Type	type = Type::none;
+
+	union
+	{
+		juce::int64		i = 0;
+		juce::uint64	u;
+		double			d;
+		const char*		s;
+		const void*		p;
+	};
+};
+//-------------------------------------------------------------------------------------------------
+
+struct RealtimeLogEntry
+{
+	static constexpr int	maxArgs = 8;
+
+	const char*		format = nullptr;
+	juce::int64		timeNs = 0;
+	juce::uint64	threadId = 0;
+	LogLevel		level = LogLevel::debuglog;
+	LogCallSite*	site = nullptr;
+	int				numArgs = 0;
+	LogArg			args[ maxArgs ];
+};
+
+static_assert ( std::is_trivially_copyable<RealtimeLogEntry>::value, "Real-time log entries must be copyable without allocating" );
+
+// Replaces each {} in format with the next argument, {{ and }} are literal braces. The text is
+// assembled in a buffer that every thread reuses, only the resulting string is allocated.
+juce::String formatLogMessage ( const char* format, const LogArg* args, int numArgs );
+
+//-------------------------------------------------------------------------------------------------
+
+template <typename... Args>
+void Logging::logRealtime ( LogLevel msgLevel, LogCallSite* site, const char* format, const Args&... args )
+{
+	static_assert ( sizeof... ( Args ) <= RealtimeLogEntry::maxArgs, "Too many arguments for a real-time log message" );
+	static_assert ( ( ! std::is_class<Args>::value && ... ), "String objects may be gone before a real-time message is formatted, use string literals" );
+
+	if ( site != nullptr ? ! site->isLevelEnabled ( msgLevel ) : ! isLevelEnabled ( msgLevel ) )
+	{
+		filteredMessages.fetch_add ( 1, std::memory_order_relaxed );
+		return;
+	}
+
+	// Never create the singleton from a real-time thread
+	auto	self = getInstanceWithoutCreating ();
+
+	if ( self == nullptr )
+		return;
+
+	RealtimeLogEntry	entry;
+	entry.format = format;
+	entry.timeNs = LogClock::now ();
+	entry.threadId = juce::uint64 ( juce::pointer_sized_int ( juce::Thread::getCurrentThreadId () ) );
+	entry.level = msgLevel;
+	entry.site = site;
+
+	( ( entry.args[ entry.numArgs++ ] = LogArg ( args ) ), ... );
+
+	if ( ! self->realtimeQueue->push ( entry ) )
+		++self->droppedRealtimeMessages;
+}
+//-------------------------------------------------------------------------------------------------
+
+template <typename... Args>
+void Logging::logFormatted ( LogLevel msgLevel, LogCallSite* site, const char* format, const Args&... args )
+{
+	if ( site != nullptr ? ! site->isLevelEnabled ( msgLevel ) : ! isLevelEnabled ( msgLevel ) )
+	{
+		filteredMessages.fetch_add ( 1, std::memory_order_relaxed );
+		return;
+	}
+
+	// Formatted right here, so the arguments only have to live until the call returns
+	const LogArg	logArgs[] = { LogArg ( args )..., LogArg () };
+
+	logMessage ( formatLogMessage ( format, logArgs, int ( sizeof... ( Args ) ) ), msgLevel, site );
+}
+//-------------------------------------------------------------------------------------------------
+}
@@ -10,10 +10,29 @@
 #ifdef _WIN32
  #include <Windows.h>
  #include <winnt.h>
+#else
+ #include <unistd.h>
 #endif
 
 #include "refx_logging.h"
 
+#include "Source/refx_LogStats.cpp"
 #include "Source/refx_Logging.cpp"
+#include "Source/refx_LogCategory.cpp"
+#include "Source/refx_LogHistory.cpp"
+#include "Source/refx_RealtimeLog.cpp"
+#include "Source/refx_LogTrace.cpp"
+#include "Source/refx_LogSystemInfo.cpp"
+#include "Source/refx_LogFolderIndex.cpp"
+#include "Source/refx_LogHousekeeper.cpp"
+#include "Source/refx_MappedLogFile.cpp"
+#include "Source/refx_LogWriter.cpp"
+#include "Source/refx_LogSink.cpp"
+#include "Source/refx_LogSinks.cpp"
+#include "Source/refx_BinaryLogFormat.cpp"
+#include "Source/refx_LogRowCache.cpp"
+#include "Source/refx_LogFileView.cpp"
+#include "Source/refx_LogSearch.cpp"
 #include "Source/refx_LoggingWindow.cpp"
 #include "Source/refx_LoggingComponent.cpp"
+#include "Source/refx_LoggingTests.cpp"
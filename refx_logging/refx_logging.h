@@ -14,7 +14,7 @@
   name:					reFX JUCE logging classes
   description:			Classes for easy logging/debugging output
   license:				none/internal use only
-  minimumCppStandard:	11
+  minimumCppStandard:	17
 
   dependencies:     juce_core, juce_events, juce_graphics, juce_gui_basics
 
@@ -25,6 +25,78 @@
 #pragma once
 #define REFX_DEBUGGING_H_INCLUDED
 
+//==============================================================================
+/** Config: REFX_LOG_MIN_LEVEL
+	Messages below this level (0 = debuglog ... 4 = error) are removed from the build entirely,
+	their Z_* macros expand to nothing.
+*/
+#ifndef REFX_LOG_MIN_LEVEL
+ #define REFX_LOG_MIN_LEVEL 0
+#endif
+
+/** Config: REFX_LOG_QUEUE_SIZE
+	Number of message slots in the lock-free queue in front of the logging pipeline.
+	Must be a power of two.
+*/
+#ifndef REFX_LOG_QUEUE_SIZE
+ #define REFX_LOG_QUEUE_SIZE 4096
+#endif
+
+/** Config: REFX_LOG_HISTORY_SIZE
+	Default number of messages kept in memory for the logging window and listeners,
+	see Logging::setHistoryCapacity.
+*/
+#ifndef REFX_LOG_HISTORY_SIZE
+ #define REFX_LOG_HISTORY_SIZE 20000
+#endif
+
+/** Config: REFX_RT_LOG_QUEUE_SIZE
+	Number of preallocated entries for messages logged with the Z_RT_* macros.
+	Must be a power of two.
+*/
+#ifndef REFX_RT_LOG_QUEUE_SIZE
+ #define REFX_RT_LOG_QUEUE_SIZE 1024
+#endif
+
+/** Config: REFX_LOG_DEBUG_OUTPUT
+	Sends every message to the debugger output, see DebugOutputLogSink. On by default in debug
+	builds only.
+*/
+#ifndef REFX_LOG_DEBUG_OUTPUT
+ #ifdef _DEBUG
+  #define REFX_LOG_DEBUG_OUTPUT 1
+ #else
+  #define REFX_LOG_DEBUG_OUTPUT 0
+ #endif
+#endif
+
+/** Config: REFX_LOG_BENCHMARKS
+	Adds the logging benchmarks to the unit tests, see refx_LoggingTests.cpp. They take a while, so
+	only enable them in a benchmark build. For allocation counts, also add
+	Source/refx_LogAllocationCounter.cpp to that build. It replaces the global operator new.
+	The refx_logging_tests target in the repository's CMakeLists.txt is such a build.
+*/
+#ifndef REFX_LOG_BENCHMARKS
+ #define REFX_LOG_BENCHMARKS 0
+#endif
+
+/** Config: REFX_LOG_STRESS_TESTS
+	Adds the logging stress test to the unit tests, see refx_LoggingTests.cpp. It logs several
+	hundred thousand messages through the Logging singleton and writes log files to the temp folder,
+	which the host's listeners and logging window see too.
+*/
+#ifndef REFX_LOG_STRESS_TESTS
+ #define REFX_LOG_STRESS_TESTS 0
+#endif
+
+/** Config: REFX_TRACE_BUFFER_SIZE
+	Number of trace events each thread buffers until the trace writer picks them up, see LogTrace.
+	Must be a power of two.
+*/
+#ifndef REFX_TRACE_BUFFER_SIZE
+ #define REFX_TRACE_BUFFER_SIZE 4096
+#endif
+
 #include <optional>
 
 #include <juce_core/juce_core.h>
@@ -34,6 +106,23 @@
 
 //==============================================================================
 
+#include "Source/refx_LogQueue.h"
+#include "Source/refx_LogStats.h"
 #include "Source/refx_Logging.h"
+#include "Source/refx_LogCategory.h"
+#include "Source/refx_LogHistory.h"
+#include "Source/refx_RealtimeLog.h"
+#include "Source/refx_LogTrace.h"
+#include "Source/refx_LogSystemInfo.h"
+#include "Source/refx_LogFolderIndex.h"
+#include "Source/refx_LogHousekeeper.h"
+#include "Source/refx_MappedLogFile.h"
+#include "Source/refx_LogWriter.h"
+#include "Source/refx_LogSink.h"
+#include "Source/refx_LogSinks.h"
+#include "Source/refx_BinaryLogFormat.h"
+#include "Source/refx_LogRowCache.h"
+#include "Source/refx_LogFileView.h"
+#include "Source/refx_LogSearch.h"
 #include "Source/refx_LoggingWindow.h"
 #include "Source/refx_LoggingComponent.h"